@@ -0,0 +1,37 @@
+#include "DragForce.h"
+/****************************************************************************/
+/*!
+\file DragForce.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A force generator that slows bodies down as they move through the air
+*/
+/****************************************************************************/
+DragForce::DragForce(const float linearCoefficient, const float quadraticCoefficient)
+	:
+linearCoefficient(linearCoefficient),
+quadraticCoefficient(quadraticCoefficient)
+{
+}
+
+DragForce::~DragForce()
+{
+}
+
+Vector3 DragForce::GetForce(const float mass, const Vector3& velocity) const
+{
+	if(velocity.IsZero())
+	{
+		return Vector3();
+	}
+	const float speed = velocity.Length();
+	const float drag = linearCoefficient * speed + quadraticCoefficient * speed * speed;
+	return velocity * (-drag / speed);
+}
+
+void DragForce::SetCoefficientsTo(const float linearCoefficient, const float quadraticCoefficient)
+{
+	this->linearCoefficient = linearCoefficient;
+	this->quadraticCoefficient = quadraticCoefficient;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "ForceGenerator.h"
+/****************************************************************************/
+/*!
+\file DragForce.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A force generator that slows bodies down as they move through the air
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class DragForce:
+\brief
+Slows bodies down opposite to their velocity. The strength of the drag is
+linearCoefficient * speed + quadraticCoefficient * speed * speed
+*/
+/****************************************************************************/
+class DragForce : public ForceGenerator
+{
+public:
+	DragForce(const float linearCoefficient = 0, const float quadraticCoefficient = 0);
+	~DragForce();
+	virtual Vector3 GetForce(const float mass, const Vector3& velocity) const;
+	void SetCoefficientsTo(const float linearCoefficient, const float quadraticCoefficient);
+private:
+	float linearCoefficient;
+	float quadraticCoefficient;
+};
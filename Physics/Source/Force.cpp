@@ -11,7 +11,8 @@ A class used to store and handle force information
 Force::Force(const Vector3 force, bool attract)
 	:
 force(force),
-attract(attract)
+attract(attract),
+lifespan(0)
 {
 }
 
@@ -41,6 +42,11 @@ void Force::SetLifespanTo(float time)
 	lifespan = time;
 }
 
+float Force::GetLifespan() const
+{
+	return lifespan;
+}
+
 bool Force::isDead() const
 {
 	if(lifespan < 0)
@@ -25,6 +25,7 @@ public:
 	Vector3 GetVector() const;
 	void UpdateTo(const double deltaTime);
 	void SetLifespanTo(float time);
+	float GetLifespan() const;
 	void SetVector(Vector3 vector);
 	void ToggleAttraction();
 	void SetToAttract();
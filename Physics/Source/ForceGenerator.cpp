@@ -0,0 +1,17 @@
+#include "ForceGenerator.h"
+/****************************************************************************/
+/*!
+\file ForceGenerator.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+An interface for forces that act on a body for as long as it is registered
+*/
+/****************************************************************************/
+ForceGenerator::ForceGenerator()
+{
+}
+
+ForceGenerator::~ForceGenerator()
+{
+}
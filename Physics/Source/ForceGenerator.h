@@ -0,0 +1,39 @@
+#pragma once
+#include "Vector3.h"
+/****************************************************************************/
+/*!
+\file ForceGenerator.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+An interface for forces that act on a body for as long as it is registered
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class ForceGenerator:
+\brief
+Interface for forces that act on a body for as long as it is registered.
+The force is recalculated every step from the state of the body.
+*/
+/****************************************************************************/
+class ForceGenerator
+{
+public:
+	ForceGenerator();
+	virtual ~ForceGenerator();
+	/****************************************************************************/
+	/*!
+	\brief
+	calculates the force acting on a body
+	\param mass
+	mass of the body
+	\param velocity
+	velocity of the body
+	\return
+	the force acting on the body
+	*/
+	/****************************************************************************/
+	virtual Vector3 GetForce(const float mass, const Vector3& velocity) const = 0;
+};
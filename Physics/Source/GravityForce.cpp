@@ -0,0 +1,34 @@
+#include "GravityForce.h"
+/****************************************************************************/
+/*!
+\file GravityForce.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A force generator that pulls bodies with a constant acceleration
+*/
+/****************************************************************************/
+GravityForce::GravityForce(const Vector3 acceleration)
+	:
+acceleration(acceleration)
+{
+}
+
+GravityForce::~GravityForce()
+{
+}
+
+Vector3 GravityForce::GetForce(const float mass, const Vector3& velocity) const
+{
+	return acceleration * mass;
+}
+
+void GravityForce::SetAccelerationTo(const Vector3 acceleration)
+{
+	this->acceleration = acceleration;
+}
+
+Vector3 GravityForce::GetAcceleration() const
+{
+	return acceleration;
+}
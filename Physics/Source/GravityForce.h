@@ -0,0 +1,30 @@
+#pragma once
+#include "ForceGenerator.h"
+/****************************************************************************/
+/*!
+\file GravityForce.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A force generator that pulls bodies with a constant acceleration
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class GravityForce:
+\brief
+Pulls bodies with a constant acceleration regardless of their mass
+*/
+/****************************************************************************/
+class GravityForce : public ForceGenerator
+{
+public:
+	GravityForce(const Vector3 acceleration = Vector3(0, -9.8f, 0));
+	~GravityForce();
+	virtual Vector3 GetForce(const float mass, const Vector3& velocity) const;
+	void SetAccelerationTo(const Vector3 acceleration);
+	Vector3 GetAcceleration() const;
+private:
+	Vector3 acceleration;
+};
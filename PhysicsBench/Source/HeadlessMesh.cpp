@@ -0,0 +1,25 @@
+#include "HeadlessMesh.h"
+/****************************************************************************/
+/*!
+\file HeadlessMesh.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A mesh that is never rendered
+*/
+/****************************************************************************/
+HeadlessMesh::HeadlessMesh()
+{
+}
+
+HeadlessMesh::~HeadlessMesh()
+{
+}
+
+void HeadlessMesh::Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled) const
+{
+}
+
+void HeadlessMesh::Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled, const unsigned& offset, const unsigned& count) const
+{
+}
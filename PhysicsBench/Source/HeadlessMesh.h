@@ -0,0 +1,29 @@
+#pragma once
+#include "Mesh.h"
+/****************************************************************************/
+/*!
+\file HeadlessMesh.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A mesh that is never rendered
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class HeadlessMesh:
+\brief
+A mesh that only holds polygons for collision. Rendering it does nothing so
+it can be used without a graphics context
+*/
+/****************************************************************************/
+class HeadlessMesh : public Mesh
+{
+public:
+	HeadlessMesh();
+	virtual ~HeadlessMesh();
+
+	virtual void Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled) const;
+	virtual void Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled, const unsigned& offset, const unsigned& count) const;
+};
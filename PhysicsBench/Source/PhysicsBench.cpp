@@ -0,0 +1,208 @@
+#include "PhysicsBench.h"
+#include "LoadOBJ.h"
+#include "timer.h"
+#include <psapi.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+/****************************************************************************/
+/*!
+\file PhysicsBench.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A benchmark that runs the physics of the nirvana level without a window
+*/
+/****************************************************************************/
+
+//timestep of every step, the same as the game running at 60 frames per second
+const double stepTime = 1.0 / 60;
+//where the spheres are dropped, just above the spawn point of the players
+const Vector3 spawnPoint(-217, -625, 0);
+//distance between the centres of the spheres when they are spawned
+const float spawnSpacing = 3;
+
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param numOfSpheres
+		number of spheres dropped over the level
+\param numOfSteps
+		number of steps the simulation is run for
+\param objDirectory
+		the folder that holds sphere.obj and nirvana.obj
+*/
+/****************************************************************************/
+PhysicsBench::PhysicsBench(const unsigned numOfSpheres, const unsigned numOfSteps, const std::wstring& objDirectory)
+	:
+numOfSpheres(numOfSpheres),
+numOfSteps(numOfSteps),
+objDirectory(objDirectory),
+draws(NULL),
+bodies(NULL),
+numOfBodies(numOfSpheres + 1)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+PhysicsBench::~PhysicsBench()
+{
+	delete [] bodies;
+	delete [] draws;
+}
+/****************************************************************************/
+/*!
+\brief
+Loads the meshes and sets up the bodies
+\return
+		false if a mesh could not be loaded
+*/
+/****************************************************************************/
+bool PhysicsBench::Init()
+{
+	if(!ObjLoader::LoadOBJ(objDirectory + L"sphere.obj", &sphere) || !ObjLoader::LoadOBJ(objDirectory + L"nirvana.obj", &nirvana))
+	{
+		fwprintf(stderr, L"Failed to load the meshes from %s\n", objDirectory.c_str());
+		return false;
+	}
+	ReportMemory("after loading");
+
+	draws = new DrawOrder[numOfBodies];
+	bodies = new CollisionBody[numOfBodies];
+
+	draws[0].SetTo(&nirvana);
+	bodies[0].draw = &draws[0];
+	bodies[0].mesh = &nirvana;
+
+	SpawnSpheres();
+
+	physics.BuildTrees(bodies, bodies + numOfBodies);
+	ReportMemory("after spawning");
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Places the spheres in a block over the spawn point
+*/
+/****************************************************************************/
+void PhysicsBench::SpawnSpheres()
+{
+	const unsigned perRow = static_cast<unsigned>(ceil(sqrt(static_cast<double>(numOfSpheres))));
+	const float halfWidth = (perRow - 1) * spawnSpacing * 0.5f;
+
+	for(unsigned index = 0; index < numOfSpheres; ++index)
+	{
+		DrawOrder* draw = &draws[index + 1];
+		CollisionBody* body = &bodies[index + 1];
+
+		const unsigned x = index % perRow;
+		const unsigned z = (index / perRow) % perRow;
+		const unsigned y = index / (perRow * perRow);
+
+		draw->SetTo(&sphere);
+		draw->transform.translate = spawnPoint + Vector3(x * spawnSpacing - halfWidth, y * spawnSpacing, z * spawnSpacing - halfWidth);
+
+		body->draw = draw;
+		body->mesh = &sphere;
+		body->mass = 1;
+		body->SetTerminalVelocityTo(100);
+		body->SetDecelerationTo(10);
+		body->AddForceGenerator(&gravity);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Steps the simulation as fast as possible
+*/
+/****************************************************************************/
+void PhysicsBench::Run()
+{
+	stepTimes.reserve(numOfSteps);
+	contactsPerStep.reserve(numOfSteps);
+	hitsPerStep.reserve(numOfSteps);
+	awakeBodiesPerStep.reserve(numOfSteps);
+
+	StopWatch timer;
+	timer.startTimer();
+	for(unsigned step = 0; step < numOfSteps; ++step)
+	{
+		physics.UpdateTo(stepTime, bodies, bodies + numOfBodies);
+		stepTimes.push_back(timer.getElapsedTime());
+		contactsPerStep.push_back(physics.GetNumOfContacts());
+		hitsPerStep.push_back(physics.GetNumOfHits());
+		awakeBodiesPerStep.push_back(physics.GetNumOfAwakeBodies());
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Prints the peak memory use of the process so far
+\param label
+		when the memory was measured
+*/
+/****************************************************************************/
+void PhysicsBench::ReportMemory(const char* label) const
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		printf("memory %s: peak working set %.1f MB, peak commit %.1f MB\n", label,
+			counters.PeakWorkingSetSize / (1024.0 * 1024.0),
+			counters.PeakPagefileUsage / (1024.0 * 1024.0));
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Prints the step time percentiles, contacts per step and memory high-water marks
+*/
+/****************************************************************************/
+void PhysicsBench::Report() const
+{
+	if(stepTimes.empty())
+	{
+		printf("No steps were run.\n");
+		return;
+	}
+
+	std::vector<double> sorted(stepTimes);
+	std::sort(sorted.begin(), sorted.end());
+	const unsigned last = sorted.size() - 1;
+
+	double totalTime = 0;
+	double totalContacts = 0;
+	double totalHits = 0;
+	double totalAwake = 0;
+	unsigned maxContacts = 0;
+	for(unsigned step = 0; step < stepTimes.size(); ++step)
+	{
+		totalTime += stepTimes[step];
+		totalContacts += contactsPerStep[step];
+		totalHits += hitsPerStep[step];
+		totalAwake += awakeBodiesPerStep[step];
+		//timer.h brings in windows.h, whose max macro breaks std::max
+		if(contactsPerStep[step] > maxContacts)
+		{
+			maxContacts = contactsPerStep[step];
+		}
+	}
+	const unsigned numOfStepsRun = stepTimes.size();
+
+	printf("%u spheres, %u steps in %.3f s\n", numOfSpheres, numOfStepsRun, totalTime);
+	printf("step ms: mean %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n",
+		totalTime * 1000 / numOfStepsRun,
+		sorted[last * 50 / 100] * 1000,
+		sorted[last * 90 / 100] * 1000,
+		sorted[last * 99 / 100] * 1000,
+		sorted[last] * 1000);
+	printf("contacts per step: mean %.1f max %u, hits per step: mean %.1f, awake bodies per step: mean %.1f\n",
+		totalContacts / numOfStepsRun, maxContacts, totalHits / numOfStepsRun, totalAwake / numOfStepsRun);
+	ReportMemory("after running");
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "PhysicsWorld.h"
+#include "GravityForce.h"
+#include "HeadlessMesh.h"
+#include "DrawOrder.h"
+/****************************************************************************/
+/*!
+\file PhysicsBench.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A benchmark that runs the physics of the nirvana level without a window
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class PhysicsBench:
+\brief
+Drops a number of spheres over the nirvana level and steps the simulation
+as fast as possible with a fixed timestep, timing every step
+*/
+/****************************************************************************/
+class PhysicsBench
+{
+public:
+	PhysicsBench(const unsigned numOfSpheres, const unsigned numOfSteps, const std::wstring& objDirectory);
+	~PhysicsBench();
+	bool Init();
+	void Run();
+	void Report() const;
+private:
+	void SpawnSpheres();
+	void ReportMemory(const char* label) const;
+
+	unsigned numOfSpheres;
+	unsigned numOfSteps;
+	std::wstring objDirectory;
+
+	HeadlessMesh sphere;
+	HeadlessMesh nirvana;
+	//the level is the first body, the spheres come after it
+	DrawOrder* draws;
+	CollisionBody* bodies;
+	unsigned numOfBodies;
+
+	GravityForce gravity;
+	PhysicsWorld physics;
+
+	std::vector<double> stepTimes;
+	std::vector<unsigned> contactsPerStep;
+	std::vector<unsigned> hitsPerStep;
+	std::vector<unsigned> awakeBodiesPerStep;
+};
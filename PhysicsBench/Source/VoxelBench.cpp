@@ -0,0 +1,466 @@
+#include "VoxelBench.h"
+#include "VoxelOctree.h"
+#include "VoxelHashGrid.h"
+#include "MeshBuilder.h"
+#include "HeadlessMesh.h"
+#include "Voxelizer.h"
+#include "LoadOBJ.h"
+#include "VoxelPager.h"
+#include "CompressedVoxelChunk.h"
+#include "VoxelRaycaster.h"
+#include "timer.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <algorithm>
+/****************************************************************************/
+/*!
+\file VoxelBench.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A benchmark that compares the ways voxels can be stored
+*/
+/****************************************************************************/
+
+//the terrain is centred on the origin
+const int terrainOffset = -512;
+
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param numOfVoxels
+		about how many voxels the terrain is made of
+*/
+/****************************************************************************/
+VoxelBench::VoxelBench(const unsigned numOfVoxels)
+	:
+numOfVoxels(numOfVoxels)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+VoxelBench::~VoxelBench()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Makes a rolling terrain 4 voxels thick and the positions to look up
+*/
+/****************************************************************************/
+void VoxelBench::GenerateTerrain()
+{
+	const unsigned thickness = 4;
+	const unsigned side = static_cast<unsigned>(sqrt(static_cast<double>(numOfVoxels / thickness))) + 1;
+
+	voxels.clear();
+	voxels.reserve(side * side * thickness);
+	for(int x = 0; x < static_cast<int>(side); ++x)
+	{
+		for(int z = 0; z < static_cast<int>(side); ++z)
+		{
+			const int height = static_cast<int>(16 * sin(x * 0.05) * cos(z * 0.07));
+			for(int y = 0; y < static_cast<int>(thickness); ++y)
+			{
+				Voxel voxel;
+				voxel.SetPositionTo(Vector3(terrainOffset + x, height - y, terrainOffset + z));
+				voxel.SetSolidityTo(1);
+				//grass on top and dirt under it so the mesher has more than 1 color to deal with
+				voxel.SetColorTo(y == 0 ? Color(0.2f, 0.6f, 0.2f) : Color(0.5f, 0.35f, 0.2f));
+				voxels.push_back(voxel);
+			}
+		}
+	}
+
+	//the same sequence every run so the numbers can be compared
+	srand(1);
+	probes.clear();
+	probes.reserve(voxels.size());
+	for(unsigned index = 0; index < voxels.size(); ++index)
+	{
+		Vector3 position = voxels[rand() % voxels.size()].GetPosition();
+		if(rand() % 2)
+		{
+			position.y += thickness;
+		}
+		probes.push_back(position);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Times one way of storing voxels
+\param name
+		name printed with the results
+\param store
+		an empty VoxelOctree or VoxelHashGrid
+*/
+/****************************************************************************/
+template<class VoxelStore>
+void VoxelBench::RunOn(const char* name, VoxelStore& store)
+{
+	StopWatch timer;
+	timer.startTimer();
+
+	for(std::vector<Voxel>::const_iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+	{
+		store.AddVoxel(*voxel);
+	}
+	//the octree only builds itself on the first lookup so that is counted as part of inserting
+	store.GetVoxel(Vector3());
+	const double insertTime = timer.getElapsedTime();
+
+	unsigned found = 0;
+	for(std::vector<Vector3>::const_iterator probe = probes.begin(); probe != probes.end(); ++probe)
+	{
+		if(store.GetVoxel(*probe))
+		{
+			++found;
+		}
+	}
+	const double lookupTime = timer.getElapsedTime();
+
+	const Vector3 neighbours[6] = {Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1)};
+	unsigned numOfNeighbours = 0;
+	for(std::vector<Voxel>::const_iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+	{
+		const Vector3 position = voxel->GetPosition();
+		for(unsigned side = 0; side < 6; ++side)
+		{
+			if(store.GetVoxel(position + neighbours[side]))
+			{
+				++numOfNeighbours;
+			}
+		}
+	}
+	const double neighbourTime = timer.getElapsedTime();
+
+	const double count = static_cast<double>(voxels.size());
+	printf("%s: insert %.1f ms (%.1f ns/voxel), lookup %.1f ms (%.1f ns/lookup, %u found), neighbours %.1f ms (%.1f ns/lookup, %u found), memory %.1f MB\n",
+		name,
+		insertTime * 1000, insertTime * 1e9 / count,
+		lookupTime * 1000, lookupTime * 1e9 / count, found,
+		neighbourTime * 1000, neighbourTime * 1e9 / (count * 6), numOfNeighbours,
+		store.GetMemoryUsed() / (1024.0 * 1024.0));
+}
+/****************************************************************************/
+/*!
+\brief
+Times meshing the terrain and compares the number of triangles against
+drawing a cube for every voxel
+*/
+/****************************************************************************/
+void VoxelBench::RunMesher()
+{
+	std::vector<Voxel*> pointers;
+	pointers.reserve(voxels.size());
+	for(std::vector<Voxel>::iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+	{
+		pointers.push_back(&*voxel);
+	}
+
+	StopWatch timer;
+	timer.startTimer();
+	HeadlessMesh mesh;
+	MeshBuilder::GenerateVoxelMesh(&mesh, pointers);
+	const double meshTime = timer.getElapsedTime();
+
+	printf("greedy mesh: %.1f ms, %u triangles instead of %u\n",
+		meshTime * 1000, mesh.GetSize(), static_cast<unsigned>(voxels.size() * 12));
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the terrain to a chunk file through a pager with a small memory
+budget, walks a camera across it and then looks up every voxel
+*/
+/****************************************************************************/
+void VoxelBench::RunPager()
+{
+	const char* path = "VoxelBench.chunks";
+	remove(path);
+	VoxelChunkFile file;
+	//32 by 4 by 32 chunks covers the terrain with the origin in the middle
+	if(!file.Open(path, 32, 4, 32))
+	{
+		printf("pager: could not open %s\n", path);
+		return;
+	}
+
+	{
+		VoxelPager pager(&file, Vector3(terrainOffset, -2 * voxelChunkSize, terrainOffset), 64 * voxelChunkBytes);
+		StopWatch timer;
+		timer.startTimer();
+
+		for(std::vector<Voxel>::const_iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+		{
+			pager.SetVoxel(*voxel);
+		}
+		pager.Flush();
+		const double writeTime = timer.getElapsedTime();
+
+		for(int x = terrainOffset; x < -terrainOffset; x += 8)
+		{
+			pager.UpdateTo(Vector3(static_cast<float>(x), 0, 0), 1);
+		}
+		const double sweepTime = timer.getElapsedTime();
+
+		unsigned found = 0;
+		Voxel voxel;
+		for(std::vector<Voxel>::const_iterator stored = voxels.begin(); stored != voxels.end(); ++stored)
+		{
+			if(pager.GetVoxel(stored->GetPosition(), &voxel))
+			{
+				++found;
+			}
+		}
+		const double lookupTime = timer.getElapsedTime();
+
+		printf("pager: write %.1f ms, camera sweep %.1f ms, lookup %.1f ms (%u found), %u page ins, %u page outs\n",
+			writeTime * 1000, sweepTime * 1000, lookupTime * 1000, found,
+			pager.GetNumOfPageIns(), pager.GetNumOfPageOuts());
+	}
+	file.Close();
+	remove(path);
+}
+/****************************************************************************/
+/*!
+\brief
+Compresses the terrain into palette and run length chunks and times
+reading every voxel back with and without a decode cache
+*/
+/****************************************************************************/
+void VoxelBench::RunCompression()
+{
+	//the same chunks as the pager uses
+	const int chunksX = 32;
+	const int chunksY = 4;
+	const Vector3 displacement(terrainOffset, -2 * voxelChunkSize, terrainOffset);
+
+	//group the voxels by chunk so only 1 chunk has to be decompressed at a time
+	std::vector<std::pair<unsigned, unsigned> > chunkOfVoxels;
+	chunkOfVoxels.reserve(voxels.size());
+	for(unsigned index = 0; index < voxels.size(); ++index)
+	{
+		const Vector3 position = voxels[index].GetPosition() - displacement;
+		const unsigned chunk = (static_cast<int>(position.z) / voxelChunkSize * chunksY + static_cast<int>(position.y) / voxelChunkSize) * chunksX + static_cast<int>(position.x) / voxelChunkSize;
+		chunkOfVoxels.push_back(std::make_pair(chunk, index));
+	}
+	std::sort(chunkOfVoxels.begin(), chunkOfVoxels.end());
+
+	StopWatch timer;
+	timer.startTimer();
+
+	std::map<unsigned, CompressedVoxelChunk> chunks;
+	std::vector<VoxelCell> cells(voxelsPerChunk);
+	std::vector<std::pair<unsigned, unsigned> >::const_iterator start = chunkOfVoxels.begin();
+	while(start != chunkOfVoxels.end())
+	{
+		const VoxelCell empty = {0, 0, 0, 0};
+		std::fill(cells.begin(), cells.end(), empty);
+		std::vector<std::pair<unsigned, unsigned> >::const_iterator end = start;
+		for(; end != chunkOfVoxels.end() && end->first == start->first; ++end)
+		{
+			const Voxel& voxel = voxels[end->second];
+			const Vector3 position = voxel.GetPosition() - displacement;
+			const int x = static_cast<int>(position.x) % voxelChunkSize;
+			const int y = static_cast<int>(position.y) % voxelChunkSize;
+			const int z = static_cast<int>(position.z) % voxelChunkSize;
+			const Color color = voxel.GetColor();
+			VoxelCell& cell = cells[(x * voxelChunkSize + z) * voxelChunkSize + y];
+			cell.red = static_cast<unsigned char>(color.r * 255 + 0.5f);
+			cell.green = static_cast<unsigned char>(color.g * 255 + 0.5f);
+			cell.blue = static_cast<unsigned char>(color.b * 255 + 0.5f);
+			cell.solidness = voxel.GetSolidness();
+		}
+		chunks[start->first].Compress(&cells[0]);
+		start = end;
+	}
+	const double compressTime = timer.getElapsedTime();
+
+	unsigned compressedBytes = 0;
+	for(std::map<unsigned, CompressedVoxelChunk>::const_iterator chunk = chunks.begin(); chunk != chunks.end(); ++chunk)
+	{
+		compressedBytes += chunk->second.GetMemoryUsage();
+	}
+
+	//read the voxels back in the order they were made, which walks down each column
+	unsigned found = 0;
+	std::map<unsigned, CompressedVoxelChunk>::const_iterator chunk = chunks.end();
+	for(std::vector<std::pair<unsigned, unsigned> >::const_iterator voxel = chunkOfVoxels.begin(); voxel != chunkOfVoxels.end(); ++voxel)
+	{
+		if(chunk == chunks.end() || chunk->first != voxel->first)
+		{
+			chunk = chunks.find(voxel->first);
+		}
+		const Vector3 position = voxels[voxel->second].GetPosition() - displacement;
+		if(chunk->second.GetCell(static_cast<int>(position.x) % voxelChunkSize, static_cast<int>(position.y) % voxelChunkSize, static_cast<int>(position.z) % voxelChunkSize).solidness)
+		{
+			++found;
+		}
+	}
+	const double lookupTime = timer.getElapsedTime();
+
+	VoxelDecodeCache cache;
+	unsigned cachedFound = 0;
+	chunk = chunks.end();
+	for(std::vector<std::pair<unsigned, unsigned> >::const_iterator voxel = chunkOfVoxels.begin(); voxel != chunkOfVoxels.end(); ++voxel)
+	{
+		if(chunk == chunks.end() || chunk->first != voxel->first)
+		{
+			chunk = chunks.find(voxel->first);
+		}
+		const Vector3 position = voxels[voxel->second].GetPosition() - displacement;
+		if(cache.GetCell(chunk->second, static_cast<int>(position.x) % voxelChunkSize, static_cast<int>(position.y) % voxelChunkSize, static_cast<int>(position.z) % voxelChunkSize).solidness)
+		{
+			++cachedFound;
+		}
+	}
+	const double cachedLookupTime = timer.getElapsedTime();
+
+	const double voxelBytes = static_cast<double>(voxels.size()) * sizeof(Voxel);
+	printf("compressed: %u chunks in %.1f KB (%.1fx smaller than Voxels, %.1fx than cells), compress %.1f ms\n",
+		static_cast<unsigned>(chunks.size()), compressedBytes / 1024.0, voxelBytes / compressedBytes,
+		static_cast<double>(chunks.size()) * voxelChunkBytes / compressedBytes, compressTime * 1000);
+	printf("compressed: lookup %.1f ms (%u found), cached lookup %.1f ms (%u found, %u hits, %u misses)\n",
+		lookupTime * 1000, found, cachedLookupTime * 1000, cachedFound, cache.GetNumOfHits(), cache.GetNumOfMisses());
+}
+/****************************************************************************/
+/*!
+\brief
+Times casting picking rays straight down onto the terrain and line of sight
+rays across it through both ways of storing voxels, and through the octree
+as 1 batch on every core
+\param octree
+		a voxelOctree holding the terrain
+\param grid
+		a voxelHashGrid holding the terrain
+*/
+/****************************************************************************/
+void VoxelBench::RunRaycasts(VoxelOctree& octree, VoxelHashGrid& grid)
+{
+	//the same sequence every run so the numbers can be compared
+	srand(2);
+	std::vector<VoxelRay> rays(probes.size());
+	for(unsigned index = 0; index < rays.size(); ++index)
+	{
+		VoxelRay& ray = rays[index];
+		const Vector3 target = probes[index];
+		if(index % 2)
+		{
+			ray.origin = Vector3(target.x, 64, target.z);
+			ray.direction = Vector3(0, -1, 0);
+			ray.maxDistance = 128;
+		}
+		else
+		{
+			ray.origin = Vector3(target.x, 24, target.z);
+			ray.direction = Vector3(static_cast<float>(rand() % 200 - 100), static_cast<float>(-(rand() % 20)), static_cast<float>(rand() % 200 - 100));
+			ray.maxDistance = 256;
+		}
+	}
+
+	//the octree is built before timing so only the rays are timed
+	octree.GetVector();
+	StopWatch timer;
+	timer.startTimer();
+
+	unsigned octreeHits = 0;
+	VoxelRayHit hit;
+	for(std::vector<VoxelRay>::const_iterator ray = rays.begin(); ray != rays.end(); ++ray)
+	{
+		if(octree.Raycast(*ray, &hit))
+		{
+			++octreeHits;
+		}
+	}
+	const double octreeTime = timer.getElapsedTime();
+
+	unsigned gridHits = 0;
+	for(std::vector<VoxelRay>::const_iterator ray = rays.begin(); ray != rays.end(); ++ray)
+	{
+		if(grid.Raycast(*ray, &hit))
+		{
+			++gridHits;
+		}
+	}
+	const double gridTime = timer.getElapsedTime();
+
+	VoxelRaycaster raycaster;
+	std::vector<VoxelRayHit> hits;
+	const unsigned batchHits = raycaster.Raycast(&octree, rays, &hits);
+	const double batchTime = timer.getElapsedTime();
+
+	const double numOfRays = static_cast<double>(rays.size());
+	printf("raycasts: octree %.1f ms (%.1f ns/ray, %u hit), hash grid %.1f ms (%.1f ns/ray, %u hit), octree batch %.1f ms (%u hit)\n",
+		octreeTime * 1000, octreeTime * 1e9 / numOfRays, octreeHits,
+		gridTime * 1000, gridTime * 1e9 / numOfRays, gridHits,
+		batchTime * 1000, batchHits);
+}
+/****************************************************************************/
+/*!
+\brief
+Runs the benchmark on every way of storing voxels
+*/
+/****************************************************************************/
+void VoxelBench::Run()
+{
+	GenerateTerrain();
+	printf("%u voxels\n", static_cast<unsigned>(voxels.size()));
+
+	VoxelOctree octree(2048, Vector3(2 * terrainOffset, 2 * terrainOffset, 2 * terrainOffset));
+	RunOn("octree", octree);
+
+	VoxelHashGrid grid;
+	RunOn("hash grid", grid);
+	RunRaycasts(octree, grid);
+
+	RunMesher();
+	RunPager();
+	RunCompression();
+}
+/****************************************************************************/
+/*!
+\brief
+Times voxelizing a mesh into a voxelOctree
+\param objFile
+		the mesh to be voxelized
+\param voxelSize
+		width of a voxel in the mesh's units
+\return
+		false if the mesh could not be loaded
+*/
+/****************************************************************************/
+bool VoxelBench::RunVoxelizer(const std::wstring& objFile, const float voxelSize)
+{
+	HeadlessMesh mesh;
+	if(!ObjLoader::LoadOBJ(objFile, &mesh))
+	{
+		return false;
+	}
+	printf("%u triangles\n", mesh.GetSize());
+
+	//centred on the origin since meshes usually are
+	const float corner = -defaultDiameter / 2.0f;
+	VoxelOctree octree(defaultDiameter, Vector3(corner, corner, corner));
+	Voxelizer voxelizer;
+	StopWatch timer;
+	timer.startTimer();
+	const unsigned numOfVoxels = voxelizer.Voxelize(&mesh, voxelSize, &octree);
+	const double voxelizeTime = timer.getElapsedTime();
+	//building the tree is part of getting the voxels ready for use
+	octree.GetVoxel(Vector3());
+	const double buildTime = timer.getElapsedTime();
+
+	printf("voxelize: %.1f ms, %u voxels of size %g, building the octree %.1f ms, memory %.1f MB\n",
+		voxelizeTime * 1000, numOfVoxels, voxelSize, buildTime * 1000,
+		octree.GetMemoryUsed() / (1024.0 * 1024.0));
+	return true;
+}
\ No newline at end of file
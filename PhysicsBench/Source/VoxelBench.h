@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "Voxel.h"
+#include "VoxelOctree.h"
+#include "VoxelHashGrid.h"
+/****************************************************************************/
+/*!
+\file VoxelBench.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A benchmark that compares the ways voxels can be stored
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class VoxelBench:
+\brief
+Fills a VoxelOctree and a VoxelHashGrid with the same terrain of voxels and
+times inserting them, looking up random positions, checking the 6
+neighbours of every voxel and casting rays through them. The terrain is
+also greedy meshed to count triangles, paged through a chunk file and
+compressed into palette and run length chunks
+*/
+/****************************************************************************/
+class VoxelBench
+{
+public:
+	VoxelBench(const unsigned numOfVoxels);
+	~VoxelBench();
+	void Run();
+	bool RunVoxelizer(const std::wstring& objFile, const float voxelSize);
+private:
+	void GenerateTerrain();
+	template<class VoxelStore>
+	void RunOn(const char* name, VoxelStore& store);
+	void RunRaycasts(VoxelOctree& octree, VoxelHashGrid& grid);
+	void RunMesher();
+	void RunPager();
+	void RunCompression();
+
+	unsigned numOfVoxels;
+	std::vector<Voxel> voxels;
+	//random positions looked up, about half of them have a voxel
+	std::vector<Vector3> probes;
+};
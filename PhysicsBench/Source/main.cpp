@@ -0,0 +1,59 @@
+#include "PhysicsBench.h"
+#include "VoxelBench.h"
+#include <cstdlib>
+#include <cstring>
+
+//usage: PhysicsBench [number of spheres] [number of steps] [obj folder]
+//       PhysicsBench voxels [number of voxels]
+//       PhysicsBench voxelize [voxel size] [obj file]
+int main(int argc, char* argv[])
+{
+	if(argc > 1 && !strcmp(argv[1], "voxels"))
+	{
+		VoxelBench bench(argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000);
+		bench.Run();
+		return EXIT_SUCCESS;
+	}
+	if(argc > 1 && !strcmp(argv[1], "voxelize"))
+	{
+		std::wstring objFile = L"..\\appz\\OBJ\\stadium.obj";
+		if(argc > 3)
+		{
+			std::string file(argv[3]);
+			objFile.assign(file.begin(), file.end());
+		}
+		VoxelBench bench(0);
+		return bench.RunVoxelizer(objFile, argc > 2 ? static_cast<float>(atof(argv[2])) : 1.0f) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	unsigned numOfSpheres = 100;
+	unsigned numOfSteps = 1000;
+	std::wstring objDirectory = L"..\\appz\\OBJ\\";
+
+	if(argc > 1)
+	{
+		numOfSpheres = strtoul(argv[1], NULL, 10);
+	}
+	if(argc > 2)
+	{
+		numOfSteps = strtoul(argv[2], NULL, 10);
+	}
+	if(argc > 3)
+	{
+		std::string directory(argv[3]);
+		objDirectory.assign(directory.begin(), directory.end());
+		if(!objDirectory.empty() && objDirectory[objDirectory.size() - 1] != L'\\' && objDirectory[objDirectory.size() - 1] != L'/')
+		{
+			objDirectory += L'\\';
+		}
+	}
+
+	PhysicsBench bench(numOfSpheres, numOfSteps, objDirectory);
+	if(!bench.Init())
+	{
+		return EXIT_FAILURE;
+	}
+	bench.Run();
+	bench.Report();
+	return EXIT_SUCCESS;
+}
@@ -15,9 +15,14 @@ Vector2 FirstPersonMouse::GetDisplacementFromCentre()
 	return position - centre;
 }
 
+const Vector2& FirstPersonMouse::GetCentre() const
+{
+	return centre;
+}
+
 void FirstPersonMouse::ToggleLock()
 {
-	fixedmouse != fixedmouse;
+	fixedmouse = !fixedmouse;
 }
 
 void FirstPersonMouse::LockMouse()
@@ -15,6 +15,7 @@ public:
 	void LockMouse();
 	void UnlockMouse();
 	Vector2 GetDisplacementFromCentre();
+	const Vector2& GetCentre() const;
 
 protected:
 	Vector2 centre;
@@ -2,6 +2,12 @@
 
 Keyboard::Keyboard()
 {
+	for(unsigned index = 0; index < 256; ++index)
+	{
+		keyAlreadyPressed[index] = false;
+		keyispressed[index] = false;
+		keyishold[index] = false;
+	}
 }
 
 Keyboard::~Keyboard()
@@ -61,4 +67,69 @@ Returns if a key that has been previously pressed has been released
 bool Keyboard::IsKeyReleased(const unsigned short& key)
 {
 	return !(IsKeyHold(key));
+}
+/****************************************************************************/
+/*!
+\brief
+Returns if a key was down during the last update, regardless of when it was pressed
+\param key
+		the key to be checked
+*/
+/****************************************************************************/
+bool Keyboard::IsKeyDown(const unsigned short& key) const
+{
+	return keyAlreadyPressed[key];
+}
+/****************************************************************************/
+/*!
+\brief
+Updates the pressed and hold states of a key from whether it is down this frame
+\param key
+		the key to be updated
+\param keyIsDown
+		if the key is down this frame
+*/
+/****************************************************************************/
+void Keyboard::SetKeyState(const unsigned short& key, const bool keyIsDown)
+{
+	if(keyAlreadyPressed[key] && !keyIsDown)
+	{
+		keyAlreadyPressed[key] = false;
+		keyispressed[key] = false;
+		keyishold[key] = false;
+	}
+	else if(!keyAlreadyPressed[key] && keyIsDown)
+	{
+		keyAlreadyPressed[key] = true;
+		keyispressed[key] = true;
+		keyishold[key] = true;
+	}
+	else if(keyAlreadyPressed[key] && keyIsDown)
+	{
+		keyispressed[key] = false;
+		keyishold[key] = true;
+	}
+	else
+	{
+		keyispressed[key] = false;
+		keyishold[key] = false;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Refills the keyboard's buffer with the printable keys pressed this frame
+*/
+/****************************************************************************/
+void Keyboard::FillKeyboardBuffer()
+{
+	//clear the buffer
+	std::queue<char>().swap(keyboardbuffer);
+	for(unsigned index = ' '; index < '~'; index++)
+	{
+		if(IsKeyPressed(index))
+		{
+			keyboardbuffer.push((char)index);
+		}
+	}
 }
\ No newline at end of file
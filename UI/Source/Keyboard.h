@@ -12,9 +12,13 @@ public:
 	virtual char GetKeyboardBuffer();
 	bool IsKeyReleased(const unsigned short& key);
 	virtual void UpdateInput() = 0;
+	bool IsKeyDown(const unsigned short& key) const;
 
 	std::queue<char> keyboardbuffer;
 	bool keyAlreadyPressed[256];
 	bool keyispressed[256];
 	bool keyishold[256];
+protected:
+	void SetKeyState(const unsigned short& key, const bool keyIsDown);
+	void FillKeyboardBuffer();
 };
\ No newline at end of file
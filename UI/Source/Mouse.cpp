@@ -5,13 +5,13 @@ Mouse::Mouse()
 	bool* end = buttonState + TOTAL_BUTTONS;
 	for(bool* state = buttonState; state != end; ++state)
 	{
-		*buttonState = false;
+		*state = false;
 	}
 
 	end = buttonStateLastFrame + TOTAL_BUTTONS;
 	for(bool* state = buttonStateLastFrame; state != end; ++state)
 	{
-		*buttonState = false;
+		*state = false;
 	}
 }
 
@@ -0,0 +1,62 @@
+#include "ReplayKeyboard.h"
+/****************************************************************************/
+/*!
+\file ReplayKeyboard.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A keyboard that plays back recorded key states
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+ReplayKeyboard::ReplayKeyboard()
+{
+	for(unsigned index = 0; index < 256; ++index)
+	{
+		nextKeysDown[index] = false;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+ReplayKeyboard::~ReplayKeyboard()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Sets which keys are down for the next update
+\param keysDown
+		the state of every key
+*/
+/****************************************************************************/
+void ReplayKeyboard::SetKeysDown(const bool keysDown[256])
+{
+	for(unsigned index = 0; index < 256; ++index)
+	{
+		nextKeysDown[index] = keysDown[index];
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Updates the keyboard values from the recorded key states
+*/
+/****************************************************************************/
+void ReplayKeyboard::UpdateInput()
+{
+	for(unsigned short index = 0; index < 256; index++)
+	{
+		SetKeyState(index, nextKeysDown[index]);
+	}
+	FillKeyboardBuffer();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Keyboard.h"
+/****************************************************************************/
+/*!
+\file ReplayKeyboard.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A keyboard that plays back recorded key states
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class ReplayKeyboard:
+\brief
+plays back recorded key states. The keys for the next frame are set with
+SetKeysDown and only take effect on UpdateInput, just like a real keyboard
+*/
+/****************************************************************************/
+class ReplayKeyboard : public Keyboard
+{
+public:
+	ReplayKeyboard();
+	~ReplayKeyboard();
+	void SetKeysDown(const bool keysDown[256]);
+	void UpdateInput();
+private:
+	bool nextKeysDown[256];
+};
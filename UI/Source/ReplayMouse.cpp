@@ -0,0 +1,77 @@
+#include "ReplayMouse.h"
+/****************************************************************************/
+/*!
+\file ReplayMouse.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A mouse that plays back recorded mouse states
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+ReplayMouse::ReplayMouse()
+{
+	nextButtonState[LEFT] = false;
+	nextButtonState[RIGHT] = false;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+ReplayMouse::~ReplayMouse()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Sets the mouse state for the next update
+\param position
+		position of the cursor
+\param centre
+		centre of the window
+\param leftButton
+		if the left button is down
+\param rightButton
+		if the right button is down
+*/
+/****************************************************************************/
+void ReplayMouse::SetNextState(const Vector2& position, const Vector2& centre, const bool leftButton, const bool rightButton)
+{
+	nextPosition = position;
+	nextCentre = centre;
+	nextButtonState[LEFT] = leftButton;
+	nextButtonState[RIGHT] = rightButton;
+}
+/****************************************************************************/
+/*!
+\brief
+Updates the mouse values from the recorded state
+*/
+/****************************************************************************/
+void ReplayMouse::Update()
+{
+	for(unsigned button = 0; button < TOTAL_BUTTONS; ++button)
+	{
+		buttonStateLastFrame[button] = buttonState[button];
+		buttonState[button] = nextButtonState[button];
+	}
+	position = nextPosition;
+	centre = nextCentre;
+}
+/****************************************************************************/
+/*!
+\brief
+The recorded positions already account for the cursor being locked so there is nothing to move
+*/
+/****************************************************************************/
+void ReplayMouse::SetToCentre()
+{
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "FirstPersonMouse.h"
+/****************************************************************************/
+/*!
+\file ReplayMouse.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A mouse that plays back recorded mouse states
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class ReplayMouse:
+\brief
+plays back recorded mouse states. The state for the next frame is set with
+SetNextState and only takes effect on Update, just like a real mouse
+*/
+/****************************************************************************/
+class ReplayMouse : public FirstPersonMouse
+{
+public:
+	ReplayMouse();
+	~ReplayMouse();
+	void SetNextState(const Vector2& position, const Vector2& centre, const bool leftButton, const bool rightButton);
+	void Update();
+	void SetToCentre();
+private:
+	Vector2 nextPosition;
+	Vector2 nextCentre;
+	bool nextButtonState[TOTAL_BUTTONS];
+};
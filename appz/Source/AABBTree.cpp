@@ -48,10 +48,11 @@ void AABBTree::Sort(const AABBBox& box, const unsigned& size)
 	mainLeaf.Sort3(box, begin, end);
 }
 
-void AABBTree::GetContacts(AABBTree* tree, Contact* buffer, Contact** end)
+//returns false if the buffer ran out before every contact was written
+bool AABBTree::GetContacts(AABBTree* tree, Contact* buffer, Contact** end, Contact*const bufferEnd)
 {
 	*end = buffer;
-	mainLeaf.GetContacts(&tree->mainLeaf, end);
+	return mainLeaf.GetContacts(&tree->mainLeaf, end, bufferEnd);
 }
 
 AABBTreeNode* AABBTree::GetBegin()
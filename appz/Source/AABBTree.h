@@ -10,7 +10,7 @@ public:
 	AABBTreeNode* GetEnd();
 	void IncreaseCapacityTo(const unsigned& size);
 	void Sort(const AABBBox& box, const unsigned& size);
-	void GetContacts(AABBTree* tree, Contact* buffer, Contact** end);
+	bool GetContacts(AABBTree* tree, Contact* buffer, Contact** end, Contact*const bufferEnd);
 private:
 	unsigned capacity;
 	AABBTreeNode* nodes;
@@ -317,7 +317,7 @@ AABBTreeLeaf* AABBTreeLeaf::GetLeaf(const AABBBox& box)
 	return NULL;
 }
 
-void AABBTreeLeaf::GetContacts(AABBTreeNode* node, Contact** iterator)
+bool AABBTreeLeaf::GetContacts(AABBTreeNode* node, Contact** iterator, Contact*const bufferEnd)
 {
 	if(leaves[LEFT].IsEmpty())
 	{
@@ -326,23 +326,29 @@ void AABBTreeLeaf::GetContacts(AABBTreeNode* node, Contact** iterator)
 		{
    			if(node->box.IsOverlapping(ourNode->box))
 			{
+				//the buffer is full, the caller has to make it bigger and check again
+				if(*iterator == bufferEnd)
+				{
+					return false;
+				}
 				(*iterator)->node2 = ourNode;
 				(*iterator)->node1 = node;
 				++(*iterator);
 			}
 		}
 	}
-	if(leaves[LEFT].box.IsOverlapping(node->box))
+	if(leaves[LEFT].box.IsOverlapping(node->box) && !leaves[LEFT].GetContacts(node, iterator, bufferEnd))
 	{
-		leaves[LEFT].GetContacts(node, iterator);
+		return false;
 	}
-	if(leaves[RIGHT].box.IsOverlapping(node->box))
+	if(leaves[RIGHT].box.IsOverlapping(node->box) && !leaves[RIGHT].GetContacts(node, iterator, bufferEnd))
 	{
-		leaves[RIGHT].GetContacts(node, iterator);
+		return false;
 	}
+	return true;
 }
 
-void AABBTreeLeaf::GetContacts(AABBTreeLeaf* leaf, Contact** iterator)
+bool AABBTreeLeaf::GetContacts(AABBTreeLeaf* leaf, Contact** iterator, Contact*const bufferEnd)
 {
 	if(leaves[LEFT].IsEmpty())
 	{
@@ -350,7 +356,10 @@ void AABBTreeLeaf::GetContacts(AABBTreeLeaf* leaf, Contact** iterator)
 		unsigned size = GetSize();
 		for(AABBTreeNode* node = begin; node != begin + size; ++node)
 		{
-			leaf->GetContacts(node, iterator);
+			if(!leaf->GetContacts(node, iterator, bufferEnd))
+			{
+				return false;
+			}
 		}
 		//if(leaf->leaves[LEFT].IsEmpty())
 		//{
@@ -376,7 +385,7 @@ void AABBTreeLeaf::GetContacts(AABBTreeLeaf* leaf, Contact** iterator)
 		//	leaf->leaves[LEFT].GetContacts(this, iterator);
 		//	leaf->leaves[RIGHT].GetContacts(this, iterator);
 		//}
-		return;
+		return true;
 	}
 	//else if(leaf->leaves[LEFT].IsEmpty())
 	//{
@@ -410,26 +419,27 @@ void AABBTreeLeaf::GetContacts(AABBTreeLeaf* leaf, Contact** iterator)
 
 	if((hitsLeft && hitsRight) || leaf->leaves[LEFT].IsEmpty())
 	{
-		if(leaves[LEFT].box.IsOverlapping(leaf->box))
+		if(leaves[LEFT].box.IsOverlapping(leaf->box) && !leaves[LEFT].GetContacts(leaf, iterator, bufferEnd))
 		{
-			leaves[LEFT].GetContacts(leaf, iterator);
+			return false;
 		}
-		if(leaves[RIGHT].box.IsOverlapping(leaf->box))
+		if(leaves[RIGHT].box.IsOverlapping(leaf->box) && !leaves[RIGHT].GetContacts(leaf, iterator, bufferEnd))
 		{
-			leaves[RIGHT].GetContacts(leaf, iterator);
+			return false;
 		}
 	}
 	else
 	{
 		if(hitsLeft)
 		{
-			GetContacts(&leaf->leaves[LEFT], iterator);
+			return GetContacts(&leaf->leaves[LEFT], iterator, bufferEnd);
 		}
 		else if(hitsRight)
 		{
-			GetContacts(&leaf->leaves[RIGHT], iterator);
+			return GetContacts(&leaf->leaves[RIGHT], iterator, bufferEnd);
 		}
 	}
+	return true;
 }
 
 bool AABBTreeLeaf::HasAlreadySubdivided() const
@@ -28,8 +28,8 @@ public:
 	void Sort2(const AABBBox& box, AABBTreeNode*const begin, AABBTreeNode*const end);
 	void Sort3(const AABBBox& box, AABBTreeNode*const begin, AABBTreeNode*const end, const unsigned char avaliableAxis = xFlag | yFlag | zFlag);
 	AABBTreeLeaf* GetLeaf(const AABBBox& box);
-	void GetContacts(AABBTreeNode* node, Contact** iterator);
-	void GetContacts(AABBTreeLeaf* leaf, Contact** iterator);
+	bool GetContacts(AABBTreeNode* node, Contact** iterator, Contact*const bufferEnd);
+	bool GetContacts(AABBTreeLeaf* leaf, Contact** iterator, Contact*const bufferEnd);
 	bool HasAlreadySubdivided() const;
 	bool IsEmpty() const;
 	const AABBBox& GetBox() const;
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 
 const unsigned char FPS = 60;
 const unsigned int frameTime = 1000 / FPS;
@@ -27,9 +28,11 @@ void resize_callback(GLFWwindow* window, const int w, const int h)
 	glViewport(0, 0, w, h); //update opengl the new window size
 }
 
-Application::Application()
+Application::Application(const APPLICATION_MODE mode, const std::string& recordingPath)
 	:
-mainScene(&keyboard, &mouse, snd, gfx)
+mode(mode),
+recordingPath(recordingPath),
+mainScene(mode == MODE_REPLAY ? static_cast<Keyboard*>(&replayKeyboard) : &keyboard, mode == MODE_REPLAY ? static_cast<FirstPersonMouse*>(&replayMouse) : &mouse, snd, gfx)
 {
 }
 
@@ -88,6 +91,18 @@ void Application::Init()
 	mouse.InitWindow(m_window);
 	gfx.Init(m_window);
 	//ShowCursor(FALSE);
+
+	if(mode == MODE_RECORD && !recorder.Open(recordingPath))
+	{
+		fprintf(stderr, "Failed to create recording %s.\n", recordingPath.c_str());
+		mode = MODE_PLAY;
+	}
+	else if(mode == MODE_REPLAY && !player.Open(recordingPath))
+	{
+		fprintf(stderr, "Failed to open recording %s.\n", recordingPath.c_str());
+		glfwTerminate();
+		exit(EXIT_FAILURE);
+	}
 }
 
 void Application::Run()
@@ -100,18 +115,77 @@ void Application::Run()
 	m_timer.startTimer();    // Start timer to calculate how long it takes to render this frame
 	while (!glfwWindowShouldClose(m_window) && !gameQuit)
 	{
-		mouse.Update();
-		keyboard.UpdateInput();
-		gameQuit = pScene->Update(m_timer.getElapsedTime());
+		double deltaTime = 0;
+		if(mode == MODE_REPLAY)
+		{
+			//the recorded timestep is used instead of the time that actually passed so the simulation plays out the same way
+			if(!player.ReadFrame(&deltaTime, &replayKeyboard, &replayMouse))
+			{
+				break;
+			}
+			replayMouse.Update();
+			replayKeyboard.UpdateInput();
+		}
+		else
+		{
+			mouse.Update();
+			keyboard.UpdateInput();
+			deltaTime = m_timer.getElapsedTime();
+			if(mode == MODE_RECORD)
+			{
+				recorder.RecordFrame(deltaTime, keyboard, mouse);
+			}
+		}
+		gameQuit = pScene->Update(deltaTime);
 		pScene->Render();
 		//Swap buffers
 		glfwSwapBuffers(m_window);
 		//Get and organize events, like keyboard and mouse input, window resizing, etc...
 		glfwPollEvents();
-        m_timer.waitUntil(frameTime);       // Frame rate limiter. Limits each frame to a specified time in ms.   
+		if(mode == MODE_REPLAY)
+		{
+			//replays run as fast as possible and time each frame
+			frameTimes.push_back(m_timer.getElapsedTime());
+		}
+		else
+		{
+			m_timer.waitUntil(frameTime);       // Frame rate limiter. Limits each frame to a specified time in ms.
+		}
 
 	} //Check if the ESC key had been pressed or if the window had been closed
 	pScene->Exit();
+
+	recorder.Close();
+	if(mode == MODE_REPLAY)
+	{
+		ReportFrameTimes();
+	}
+}
+
+void Application::ReportFrameTimes() const
+{
+	if(frameTimes.empty())
+	{
+		printf("Replay had no frames.\n");
+		return;
+	}
+
+	std::vector<double> sorted(frameTimes);
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0;
+	for(std::vector<double>::const_iterator time = sorted.begin(); time != sorted.end(); ++time)
+	{
+		total += *time;
+	}
+	const unsigned last = sorted.size() - 1;
+
+	printf("Replayed %u frames in %.3f s\n", (unsigned)sorted.size(), total);
+	printf("frame ms: mean %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n",
+		total * 1000 / sorted.size(),
+		sorted[last * 50 / 100] * 1000,
+		sorted[last * 90 / 100] * 1000,
+		sorted[last * 99 / 100] * 1000,
+		sorted[last] * 1000);
 }
 
 void Application::Exit()
@@ -8,17 +8,42 @@
 #include "WindowsKeyboard.h"
 #include "GLMouse.h"
 #include "SceneMain.h"
+#include "ReplayKeyboard.h"
+#include "ReplayMouse.h"
+#include "InputRecorder.h"
+#include "InputPlayer.h"
+#include <vector>
 
 class Application
 {
 public:
-	Application();
+	enum APPLICATION_MODE
+	{
+		//normal play
+		MODE_PLAY,
+		//normal play while recording the input and timesteps of every frame
+		MODE_RECORD,
+		//plays back a recording as fast as possible and reports the frame times
+		MODE_REPLAY,
+	};
+
+	Application(const APPLICATION_MODE mode = MODE_PLAY, const std::string& recordingPath = "");
 	~Application();
 	void Init();
 	void Run();
 	void Exit();
 
 private:
+	void ReportFrameTimes() const;
+
+	APPLICATION_MODE mode;
+	std::string recordingPath;
+	InputRecorder recorder;
+	InputPlayer player;
+	ReplayKeyboard replayKeyboard;
+	ReplayMouse replayMouse;
+	std::vector<double> frameTimes;
+
 	SceneMain mainScene;
 	StopWatch m_timer;
 	GLFWwindow* m_window;
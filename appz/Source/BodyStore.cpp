@@ -0,0 +1,340 @@
+#include "BodyStore.h"
+#include <xmmintrin.h>
+#include <cstring>
+/****************************************************************************/
+/*!
+\file BodyStore.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Stores the state of awake bodies as separate arrays so they can be integrated with SIMD
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+BodyStore::BodyStore()
+	:
+bodies(NULL),
+size(0),
+capacity(0)
+{
+	for(unsigned index = 0; index < A_TOTAL; ++index)
+	{
+		arrays[index] = NULL;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+BodyStore::~BodyStore()
+{
+	for(unsigned index = 0; index < A_TOTAL; ++index)
+	{
+		_mm_free(arrays[index]);
+	}
+	delete [] bodies;
+}
+/****************************************************************************/
+/*!
+\brief
+Grows the arrays so that they can hold at least newCapacity bodies.
+Only called when the number of awake bodies outgrows the store.
+\param newCapacity
+the number of bodies the arrays should hold
+*/
+/****************************************************************************/
+void BodyStore::Reserve(const unsigned newCapacity)
+{
+	if(newCapacity <= capacity)
+	{
+		return;
+	}
+	unsigned paddedCapacity = capacity ? capacity : 4;
+	while(paddedCapacity < newCapacity)
+	{
+		paddedCapacity *= 2;
+	}
+
+	for(unsigned index = 0; index < A_TOTAL; ++index)
+	{
+		float* newArray = static_cast<float*>(_mm_malloc(paddedCapacity * sizeof(float), 16));
+		//the padding gets loaded by the SIMD loops so it must hold valid numbers
+		memset(newArray, 0, paddedCapacity * sizeof(float));
+		if(arrays[index])
+		{
+			memcpy(newArray, arrays[index], size * sizeof(float));
+			_mm_free(arrays[index]);
+		}
+		arrays[index] = newArray;
+	}
+
+	CollisionBody** newBodies = new CollisionBody*[paddedCapacity];
+	if(bodies)
+	{
+		memcpy(newBodies, bodies, size * sizeof(CollisionBody*));
+		delete [] bodies;
+	}
+	bodies = newBodies;
+	capacity = paddedCapacity;
+}
+/****************************************************************************/
+/*!
+\brief
+Number of elements the SIMD loops go through
+*/
+/****************************************************************************/
+unsigned BodyStore::GetPaddedSize() const
+{
+	return (size + 3) & ~3u;
+}
+/****************************************************************************/
+/*!
+\brief
+Copies the velocities, accelerations and terminal velocities of all awake bodies into the store
+\param begin
+first body
+\param end
+one past the last body
+*/
+/****************************************************************************/
+void BodyStore::Gather(CollisionBody*const begin, CollisionBody*const end)
+{
+	size = 0;
+	Reserve(end - begin);
+	for(CollisionBody* body = begin; body != end; ++body)
+	{
+		//collisions are counted from scratch every step
+		body->ClearCollisions();
+		if(body->IsAsleep())
+		{
+			continue;
+		}
+		const Vector3 acceleration = body->GetAcceleration();
+
+		bodies[size] = body;
+		arrays[A_VELOCITY_X][size] = body->velocity.x;
+		arrays[A_VELOCITY_Y][size] = body->velocity.y;
+		arrays[A_VELOCITY_Z][size] = body->velocity.z;
+		arrays[A_ROTATION_VELOCITY_X][size] = body->rotationVelocity.x;
+		arrays[A_ROTATION_VELOCITY_Y][size] = body->rotationVelocity.y;
+		arrays[A_ROTATION_VELOCITY_Z][size] = body->rotationVelocity.z;
+		arrays[A_ACCELERATION_X][size] = acceleration.x;
+		arrays[A_ACCELERATION_Y][size] = acceleration.y;
+		arrays[A_ACCELERATION_Z][size] = acceleration.z;
+		arrays[A_TERMINAL_VELOCITY][size] = body->GetTerminalVelocity();
+		++size;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Reloads the velocities after collision response along with the
+deceleration and transform of the gathered bodies
+*/
+/****************************************************************************/
+void BodyStore::GatherTransforms()
+{
+	for(unsigned index = 0; index < size; ++index)
+	{
+		const CollisionBody* body = bodies[index];
+		const Transformation& transform = body->draw->transform;
+
+		arrays[A_VELOCITY_X][index] = body->velocity.x;
+		arrays[A_VELOCITY_Y][index] = body->velocity.y;
+		arrays[A_VELOCITY_Z][index] = body->velocity.z;
+		//a body slows down once for every body it collided with
+		arrays[A_DECELERATION][index] = body->GetDeceleration() * body->GetNumOfCollisions();
+		arrays[A_TRANSLATE_X][index] = transform.translate.x;
+		arrays[A_TRANSLATE_Y][index] = transform.translate.y;
+		arrays[A_TRANSLATE_Z][index] = transform.translate.z;
+		arrays[A_YAW][index] = transform.rotate.yaw;
+		arrays[A_PITCH][index] = transform.rotate.pitch;
+		arrays[A_ROLL][index] = transform.rotate.roll;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the velocities back to the bodies
+*/
+/****************************************************************************/
+void BodyStore::ScatterVelocities() const
+{
+	for(unsigned index = 0; index < size; ++index)
+	{
+		bodies[index]->velocity.Set(arrays[A_VELOCITY_X][index], arrays[A_VELOCITY_Y][index], arrays[A_VELOCITY_Z][index]);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the velocities and transforms back to the bodies
+*/
+/****************************************************************************/
+void BodyStore::ScatterTransforms() const
+{
+	for(unsigned index = 0; index < size; ++index)
+	{
+		CollisionBody* body = bodies[index];
+		//substepping bodies have already been moved and slowed down by their substeps
+		if(body->IsSubstepping())
+		{
+			continue;
+		}
+		Transformation& transform = body->draw->transform;
+
+		body->velocity.Set(arrays[A_VELOCITY_X][index], arrays[A_VELOCITY_Y][index], arrays[A_VELOCITY_Z][index]);
+		transform.translate.Set(arrays[A_TRANSLATE_X][index], arrays[A_TRANSLATE_Y][index], arrays[A_TRANSLATE_Z][index]);
+		transform.rotate.yaw = arrays[A_YAW][index];
+		transform.rotate.pitch = arrays[A_PITCH][index];
+		transform.rotate.roll = arrays[A_ROLL][index];
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+velocity += acceleration * deltaTime for all bodies
+\param deltaTime
+time passed
+*/
+/****************************************************************************/
+void BodyStore::IntegrateVelocities(const float deltaTime)
+{
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const unsigned paddedSize = GetPaddedSize();
+	for(unsigned axis = 0; axis < 3; ++axis)
+	{
+		float* velocity = arrays[A_VELOCITY_X + axis];
+		const float* acceleration = arrays[A_ACCELERATION_X + axis];
+		for(unsigned index = 0; index < paddedSize; index += 4)
+		{
+			const __m128 v = _mm_load_ps(velocity + index);
+			const __m128 a = _mm_load_ps(acceleration + index);
+			_mm_store_ps(velocity + index, _mm_add_ps(v, _mm_mul_ps(a, dt)));
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+scales down the velocities that are faster than their terminal velocity
+*/
+/****************************************************************************/
+void BodyStore::CapVelocities()
+{
+	const unsigned paddedSize = GetPaddedSize();
+	float* velocityX = arrays[A_VELOCITY_X];
+	float* velocityY = arrays[A_VELOCITY_Y];
+	float* velocityZ = arrays[A_VELOCITY_Z];
+	const float* terminalVelocity = arrays[A_TERMINAL_VELOCITY];
+	const __m128 one = _mm_set1_ps(1.0f);
+	for(unsigned index = 0; index < paddedSize; index += 4)
+	{
+		const __m128 x = _mm_load_ps(velocityX + index);
+		const __m128 y = _mm_load_ps(velocityY + index);
+		const __m128 z = _mm_load_ps(velocityZ + index);
+		const __m128 terminal = _mm_load_ps(terminalVelocity + index);
+
+		const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		//terminal * terminal is infinity for bodies without a terminal velocity so they are never capped
+		const __m128 tooFast = _mm_cmpgt_ps(lengthSquared, _mm_mul_ps(terminal, terminal));
+		const __m128 capped = _mm_div_ps(terminal, _mm_sqrt_ps(lengthSquared));
+		const __m128 scale = _mm_or_ps(_mm_and_ps(tooFast, capped), _mm_andnot_ps(tooFast, one));
+
+		_mm_store_ps(velocityX + index, _mm_mul_ps(x, scale));
+		_mm_store_ps(velocityY + index, _mm_mul_ps(y, scale));
+		_mm_store_ps(velocityZ + index, _mm_mul_ps(z, scale));
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+slows down the velocities of bodies that collided this step
+\param deltaTime
+time passed
+*/
+/****************************************************************************/
+void BodyStore::Decelerate(const float deltaTime)
+{
+	const unsigned paddedSize = GetPaddedSize();
+	float* velocityX = arrays[A_VELOCITY_X];
+	float* velocityY = arrays[A_VELOCITY_Y];
+	float* velocityZ = arrays[A_VELOCITY_Z];
+	const float* deceleration = arrays[A_DECELERATION];
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	for(unsigned index = 0; index < paddedSize; index += 4)
+	{
+		const __m128 x = _mm_load_ps(velocityX + index);
+		const __m128 y = _mm_load_ps(velocityY + index);
+		const __m128 z = _mm_load_ps(velocityZ + index);
+		const __m128 loss = _mm_mul_ps(_mm_load_ps(deceleration + index), dt);
+
+		const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+		//bodies that would lose more speed than they have stop completely, this also masks out the division by a zero length
+		const __m128 stops = _mm_cmple_ps(length, loss);
+		const __m128 scale = _mm_andnot_ps(stops, _mm_div_ps(_mm_sub_ps(length, loss), length));
+
+		_mm_store_ps(velocityX + index, _mm_mul_ps(x, scale));
+		_mm_store_ps(velocityY + index, _mm_mul_ps(y, scale));
+		_mm_store_ps(velocityZ + index, _mm_mul_ps(z, scale));
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+moves and rotates all bodies by their velocities
+\param deltaTime
+time passed
+*/
+/****************************************************************************/
+void BodyStore::IntegratePositions(const float deltaTime)
+{
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const unsigned paddedSize = GetPaddedSize();
+	for(unsigned axis = 0; axis < 3; ++axis)
+	{
+		float* translate = arrays[A_TRANSLATE_X + axis];
+		const float* velocity = arrays[A_VELOCITY_X + axis];
+		//yaw, pitch and roll are driven by the x, y and z of the rotation velocity
+		float* rotate = arrays[A_YAW + axis];
+		const float* rotationVelocity = arrays[A_ROTATION_VELOCITY_X + axis];
+		for(unsigned index = 0; index < paddedSize; index += 4)
+		{
+			const __m128 p = _mm_load_ps(translate + index);
+			const __m128 v = _mm_load_ps(velocity + index);
+			_mm_store_ps(translate + index, _mm_add_ps(p, _mm_mul_ps(v, dt)));
+
+			const __m128 r = _mm_load_ps(rotate + index);
+			const __m128 w = _mm_load_ps(rotationVelocity + index);
+			_mm_store_ps(rotate + index, _mm_add_ps(r, _mm_mul_ps(w, dt)));
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+number of bodies gathered
+*/
+/****************************************************************************/
+unsigned BodyStore::GetSize() const
+{
+	return size;
+}
+/****************************************************************************/
+/*!
+\brief
+the bodies gathered, in the order of the arrays
+*/
+/****************************************************************************/
+CollisionBody*const* BodyStore::GetBodies() const
+{
+	return bodies;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "CollisionBody.h"
+/****************************************************************************/
+/*!
+\file BodyStore.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Stores the state of awake bodies as separate arrays so they can be integrated with SIMD
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class BodyStore:
+\brief
+Stores the state that gets touched every step (velocities, accelerations,
+transforms) of all awake bodies in structure of arrays form. Each array is
+16 byte aligned and padded to a multiple of 4 so that the integration loops
+can work on 4 bodies at a time with SSE.
+
+The bodies are gathered from the CollisionBody array, integrated and then
+scattered back.
+*/
+/****************************************************************************/
+class BodyStore
+{
+public:
+	BodyStore();
+	~BodyStore();
+
+	void Gather(CollisionBody*const begin, CollisionBody*const end);
+	void GatherTransforms();
+	void ScatterVelocities() const;
+	void ScatterTransforms() const;
+
+	void IntegrateVelocities(const float deltaTime);
+	void CapVelocities();
+	void Decelerate(const float deltaTime);
+	void IntegratePositions(const float deltaTime);
+
+	unsigned GetSize() const;
+	CollisionBody*const* GetBodies() const;
+private:
+	enum ARRAY_TYPE
+	{
+		A_VELOCITY_X = 0,
+		A_VELOCITY_Y,
+		A_VELOCITY_Z,
+		A_ROTATION_VELOCITY_X,
+		A_ROTATION_VELOCITY_Y,
+		A_ROTATION_VELOCITY_Z,
+		A_ACCELERATION_X,
+		A_ACCELERATION_Y,
+		A_ACCELERATION_Z,
+		A_TERMINAL_VELOCITY,
+		A_DECELERATION,
+		A_TRANSLATE_X,
+		A_TRANSLATE_Y,
+		A_TRANSLATE_Z,
+		A_YAW,
+		A_PITCH,
+		A_ROLL,
+
+		A_TOTAL,
+	};
+
+	void Reserve(const unsigned newCapacity);
+	unsigned GetPaddedSize() const;
+
+	float* arrays[A_TOTAL];
+	CollisionBody** bodies;
+	unsigned size;
+	unsigned capacity;
+};
@@ -1,5 +1,7 @@
 #include "CollisionBody.h"
 #include "MyMath.h"
+#include <cfloat>
+#include <cmath>
 #include "VoxelOctree.h"
 /****************************************************************************/
 /*!
@@ -13,13 +15,21 @@ A class used to represent a physical body
 CollisionBody::CollisionBody(DrawOrder* draw, float mass, float bounce, float staticFriction, float kineticFriction)
 	:
 draw(draw),
+mesh(NULL),
 mass(mass),
 bounce(bounce),
 staticFriction(staticFriction),
 kineticFriction(kineticFriction),
+soundSys(NULL),
 deceleration(0),
-mesh(NULL),
-soundSys(NULL)
+terminalVelocity(FLT_MAX),
+numOfCollisions(0),
+numOfTimedForces(0),
+sleepTimer(0),
+asleep(false),
+island(0),
+featureSize(FLT_MAX),
+numOfSubsteps(1)
 {
 }
 
@@ -42,17 +52,20 @@ void CollisionBody::SetTerminalVelocityTo(float terminal)
 
 void CollisionBody::UpdateForcesTo(const double deltaTime)
 {
-	std::vector<Force>::iterator force = forces.begin();
-	while(force != forces.end())
+	accumulatedForce.SetZero();
+
+	unsigned index = 0;
+	while(index < numOfTimedForces)
 	{
-		force->UpdateTo(deltaTime);
-		if(force->isDead())
+		timedForces[index].UpdateTo(deltaTime);
+		if(timedForces[index].isDead())
 		{
-			force = forces.erase(force);
+			//order doesn't matter so the last force takes the place of the dead one
+			timedForces[index] = timedForces[--numOfTimedForces];
 		}
 		else
 		{
-			++force;
+			++index;
 		}
 	}
 }
@@ -119,28 +132,68 @@ void CollisionBody::LoseMomentumTo(CollisionBody* draw, Vector3 momentumLost)
 
 void CollisionBody::AddForce(Vector3 force)
 {
-	Force actualForce;
-	actualForce.SetLifespanTo(0);
-	actualForce.SetVector(force);
-	forces.push_back(actualForce);
+	WakeUp();
+	accumulatedForce += force;
 }
 
 void CollisionBody::AddForce(Force force)
 {
-	forces.push_back(force);
+	//a zero force does nothing to the body, don't let it pile up while the body sleeps
+	if(force.GetVector().IsZero())
+	{
+		return;
+	}
+	WakeUp();
+
+	if(!force.isDead() && force.GetLifespan() == 0)
+	{
+		permanentForce += force.GetVector();
+	}
+	else if(numOfTimedForces < maxTimedForces)
+	{
+		timedForces[numOfTimedForces++] = force;
+	}
+	else
+	{
+		//no more room for the force, it only gets to act for this step
+		accumulatedForce += force.GetVector();
+	}
 }
 
-Vector3 CollisionBody::GetAcceleration()
+void CollisionBody::AddForceGenerator(ForceGenerator* generator)
+{
+	generators.push_back(generator);
+}
+
+void CollisionBody::RemoveForceGenerator(ForceGenerator* generator)
 {
-	Vector3 acceleration;
-	for(std::vector<Force>::iterator force = forces.begin(); force != forces.end(); force++)
+	for(std::vector<ForceGenerator*>::iterator it = generators.begin(); it != generators.end(); ++it)
 	{
-		if(mass)
+		if(*it == generator)
 		{
-			acceleration += force->GetVector() / mass;
+			generators.erase(it);
+			return;
 		}
 	}
-	return acceleration;
+}
+
+Vector3 CollisionBody::GetAcceleration()
+{
+	if(!mass)
+	{
+		return Vector3();
+	}
+
+	Vector3 force = accumulatedForce + permanentForce;
+	for(unsigned index = 0; index < numOfTimedForces; ++index)
+	{
+		force += timedForces[index].GetVector();
+	}
+	for(std::vector<ForceGenerator*>::const_iterator generator = generators.begin(); generator != generators.end(); ++generator)
+	{
+		force += (*generator)->GetForce(mass, velocity);
+	}
+	return force / mass;
 }
 
 void CollisionBody::Decelerate(double deltaTime)
@@ -157,6 +210,31 @@ void CollisionBody::SetDecelerationTo(float decelerate)
 	deceleration = abs(decelerate);
 }
 
+float CollisionBody::GetDeceleration() const
+{
+	return deceleration;
+}
+
+float CollisionBody::GetTerminalVelocity() const
+{
+	return terminalVelocity;
+}
+
+void CollisionBody::AddCollision()
+{
+	++numOfCollisions;
+}
+
+unsigned CollisionBody::GetNumOfCollisions() const
+{
+	return numOfCollisions;
+}
+
+void CollisionBody::ClearCollisions()
+{
+	numOfCollisions = 0;
+}
+
 Vector3 CollisionBody::GetMomentum()
 {
 	return velocity * mass;
@@ -222,4 +300,93 @@ float CollisionBody::GetMaxZ() const
 float CollisionBody::GetMinZ() const
 {
 	return 0;
+}
+
+float CollisionBody::GetSpecificKinetic() const
+{
+	//kinetic energy per unit of mass so that massless kinematic bodies can be measured too
+	return 0.5f * (velocity.LengthSquared() + rotationVelocity.LengthSquared());
+}
+
+void CollisionBody::UpdateSleep(const double deltaTime)
+{
+	if(GetSpecificKinetic() < sleepEnergyThreshold)
+	{
+		sleepTimer += deltaTime;
+	}
+	else
+	{
+		sleepTimer = 0;
+	}
+}
+
+bool CollisionBody::CanSleep() const
+{
+	return sleepTimer >= timeToSleep;
+}
+
+void CollisionBody::Sleep(const unsigned island)
+{
+	asleep = true;
+	this->island = island;
+	velocity.SetZero();
+	rotationVelocity.SetZero();
+	numOfSubsteps = 1;
+}
+
+void CollisionBody::WakeUp()
+{
+	asleep = false;
+	sleepTimer = 0;
+}
+
+bool CollisionBody::IsAsleep() const
+{
+	return asleep;
+}
+
+unsigned CollisionBody::GetIsland() const
+{
+	return island;
+}
+
+void CollisionBody::SetFeatureSizeTo(const float size)
+{
+	//flat or empty meshes have no thickness to tunnel through
+	featureSize = size > 0 ? size : FLT_MAX;
+}
+
+float CollisionBody::GetFeatureSize() const
+{
+	return featureSize;
+}
+
+void CollisionBody::UpdateSubstepsTo(const double deltaTime)
+{
+	numOfSubsteps = 1;
+	if(!mesh || asleep)
+	{
+		return;
+	}
+
+	//take as many steps as it needs so that it never moves more than its own size at a time
+	const double distance = velocity.Length() * deltaTime;
+	if(distance > featureSize)
+	{
+		numOfSubsteps = static_cast<unsigned>(ceil(distance / featureSize));
+		if(numOfSubsteps > maxSubsteps)
+		{
+			numOfSubsteps = maxSubsteps;
+		}
+	}
+}
+
+unsigned CollisionBody::GetNumOfSubsteps() const
+{
+	return numOfSubsteps;
+}
+
+bool CollisionBody::IsSubstepping() const
+{
+	return numOfSubsteps > 1;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "Force.h"
+#include "ForceGenerator.h"
 #include "Sound.h"
 #include "DrawOrder.h"
 #include "AABBTree.h"
@@ -13,6 +14,34 @@ A class used to represent a physical body
 */
 /****************************************************************************/
 
+/****************************************************************************/
+/*!
+\brief
+kinetic energy per unit of mass under which a body is considered to be resting
+*/
+/****************************************************************************/
+const float sleepEnergyThreshold = 0.5f;
+/****************************************************************************/
+/*!
+\brief
+number of seconds a body has to stay resting before it is put to sleep
+*/
+/****************************************************************************/
+const float timeToSleep = 1.0f;
+/****************************************************************************/
+/*!
+\brief
+maximum number of timed forces that can act on a body at once
+*/
+/****************************************************************************/
+const unsigned maxTimedForces = 8;
+/****************************************************************************/
+/*!
+\brief
+maximum number of substeps a fast body can be split into in a single step
+*/
+/****************************************************************************/
+const unsigned maxSubsteps = 16;
 /****************************************************************************/
 /*!
 Class CollisionBody:
@@ -35,6 +64,8 @@ public:
 	void LoseMomentumTo(CollisionBody* draw, Vector3 momentumLost);
 	void AddForce(Vector3 force);
 	void AddForce(Force force);
+	void AddForceGenerator(ForceGenerator* generator);
+	void RemoveForceGenerator(ForceGenerator* generator);
 	Vector3 GetAcceleration();
 	Vector3 GetMomentum();
 	void SetMomentumTo(Vector3 momentum);
@@ -51,7 +82,24 @@ public:
 	bool IsCollidingWith(CollisionBody* body);
 	void Decelerate(double deltaTime);
 	void SetDecelerationTo(float decelerate);
+	float GetDeceleration() const;
+	float GetTerminalVelocity() const;
+	void AddCollision();
+	unsigned GetNumOfCollisions() const;
+	void ClearCollisions();
 	void RespondToCollision();
+	float GetSpecificKinetic() const;
+	void UpdateSleep(const double deltaTime);
+	bool CanSleep() const;
+	void Sleep(const unsigned island);
+	void WakeUp();
+	bool IsAsleep() const;
+	unsigned GetIsland() const;
+	void SetFeatureSizeTo(const float size);
+	float GetFeatureSize() const;
+	void UpdateSubstepsTo(const double deltaTime);
+	unsigned GetNumOfSubsteps() const;
+	bool IsSubstepping() const;
 
 	Vector3 rotationVelocity;
 	DrawOrder* draw;
@@ -67,5 +115,21 @@ public:
 private:
 	float deceleration;
 	float terminalVelocity;
-	std::vector<Force> forces;
+	//number of bodies this body collided with during the current step
+	unsigned numOfCollisions;
+	//forces added through AddForce(Vector3) that only last for the current step
+	Vector3 accumulatedForce;
+	//sum of all forces with no lifespan
+	Vector3 permanentForce;
+	Force timedForces[maxTimedForces];
+	unsigned numOfTimedForces;
+	std::vector<ForceGenerator*> generators;
+
+	double sleepTimer;
+	bool asleep;
+	unsigned island;
+
+	//smallest extent of the body's mesh, a body moving further than this in a step can skip past thin walls
+	float featureSize;
+	unsigned numOfSubsteps;
 };
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "CollisionEvent.h"
+/****************************************************************************/
+/*!
+\file CollisionEvent.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Classes used to report collisions after the physics step
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param body1
+		the first body of the pair
+\param body2
+		the second body of the pair
+*/
+/****************************************************************************/
+CollisionEvent::CollisionEvent(CollisionBody* body1, CollisionBody* body2)
+	:
+body1(body1),
+body2(body2),
+impact(0),
+numOfHits(0),
+bounced1(false),
+bounced2(false)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+CollisionEvent::~CollisionEvent()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Adds the hits of a later event between the same bodies to this one
+\param event
+		the later event
+*/
+/****************************************************************************/
+void CollisionEvent::MergeWith(const CollisionEvent& event)
+{
+	if(!numOfHits)
+	{
+		point = event.point;
+	}
+	if(event.impact > impact)
+	{
+		impact = event.impact;
+	}
+	numOfHits += event.numOfHits;
+	bounced1 = bounced1 || event.bounced1;
+	bounced2 = bounced2 || event.bounced2;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+CollisionListener::~CollisionListener()
+{
+}
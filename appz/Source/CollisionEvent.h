@@ -0,0 +1,59 @@
+#pragma once
+#include "Vector3.h"
+/****************************************************************************/
+/*!
+\file CollisionEvent.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Classes used to report collisions after the physics step
+*/
+/****************************************************************************/
+class CollisionBody;
+/****************************************************************************/
+/*!
+Class CollisionEvent:
+\brief
+Everything that happened between a pair of bodies during a step. All the
+hits between the same pair are merged into one event.
+*/
+/****************************************************************************/
+class CollisionEvent
+{
+public:
+	CollisionEvent(CollisionBody* body1 = NULL, CollisionBody* body2 = NULL);
+	~CollisionEvent();
+	void MergeWith(const CollisionEvent& event);
+
+	CollisionBody* body1;
+	CollisionBody* body2;
+	//where the first hit between the bodies was
+	Vector3 point;
+	//fastest speed either body hit the other with along the normal
+	float impact;
+	unsigned numOfHits;
+	//whether the body bounced off the other one
+	bool bounced1;
+	bool bounced2;
+};
+/****************************************************************************/
+/*!
+Class CollisionListener:
+\brief
+Interface for anything that wants to hear about collisions
+*/
+/****************************************************************************/
+class CollisionListener
+{
+public:
+	virtual ~CollisionListener();
+	/****************************************************************************/
+	/*!
+	\brief
+	called once for every pair of bodies that collided during the step
+	\param event
+	the collision
+	*/
+	/****************************************************************************/
+	virtual void OnCollision(const CollisionEvent& event) = 0;
+};
@@ -0,0 +1,202 @@
+#include "CollisionEventQueue.h"
+#include "CollisionBody.h"
+#include <algorithm>
+/****************************************************************************/
+/*!
+\file CollisionEventQueue.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A queue that holds the collisions of a step until they are dispatched
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param expectedNumOfEvents
+		number of events a step is expected to push, used to reserve space
+*/
+/****************************************************************************/
+CollisionEventQueue::CollisionEventQueue(const unsigned expectedNumOfEvents)
+{
+	events.reserve(expectedNumOfEvents);
+	order.reserve(expectedNumOfEvents);
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+CollisionEventQueue::~CollisionEventQueue()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Adds an event to the queue. It is merged with the other events of the same
+pair when the queue is dispatched
+\param event
+		the event to add
+*/
+/****************************************************************************/
+void CollisionEventQueue::Push(const CollisionEvent& event)
+{
+	BodyPair pair(event.body1, event.body2);
+	if(pair.second < pair.first)
+	{
+		std::swap(pair.first, pair.second);
+	}
+	order.push_back(std::make_pair(pair, static_cast<unsigned>(events.size())));
+	events.push_back(event);
+}
+/****************************************************************************/
+/*!
+\brief
+Merges the events of every pair into the first event of the pair and removes
+the rest, leaving the events in the order their pair first collided
+*/
+/****************************************************************************/
+void CollisionEventQueue::Merge()
+{
+	//the events of a pair end up next to each other in the order they were pushed
+	std::sort(order.begin(), order.end());
+
+	unsigned first = 0;
+	for(unsigned index = 1; index < order.size(); ++index)
+	{
+		if(order[index].first != order[first].first)
+		{
+			first = index;
+			continue;
+		}
+		CollisionEvent& queued = events[order[first].second];
+		CollisionEvent& event = events[order[index].second];
+		if(queued.body1 == event.body1)
+		{
+			queued.MergeWith(event);
+		}
+		else
+		{
+			//same pair the other way around
+			CollisionEvent swapped(event);
+			std::swap(swapped.body1, swapped.body2);
+			std::swap(swapped.bounced1, swapped.bounced2);
+			queued.MergeWith(swapped);
+		}
+		//marks the event as merged
+		event.body1 = NULL;
+	}
+	order.clear();
+
+	unsigned numOfEvents = 0;
+	for(unsigned index = 0; index < events.size(); ++index)
+	{
+		if(events[index].body1)
+		{
+			events[numOfEvents++] = events[index];
+		}
+	}
+	events.resize(numOfEvents);
+}
+/****************************************************************************/
+/*!
+\brief
+Lets the bodies that bounced react to their hits, sends every event to the
+listeners and empties the queue
+*/
+/****************************************************************************/
+void CollisionEventQueue::Dispatch()
+{
+	Merge();
+	for(std::vector<CollisionEvent>::const_iterator event = events.begin(); event != events.end(); ++event)
+	{
+		if(event->bounced1)
+		{
+			event->body1->RespondToCollision();
+		}
+		if(event->bounced2)
+		{
+			event->body2->RespondToCollision();
+		}
+		for(std::vector<CollisionListener*>::const_iterator listener = listeners.begin(); listener != listeners.end(); ++listener)
+		{
+			(*listener)->OnCollision(*event);
+		}
+	}
+	Clear();
+}
+/****************************************************************************/
+/*!
+\brief
+Throws away the queued events without dispatching them
+*/
+/****************************************************************************/
+void CollisionEventQueue::Clear()
+{
+	events.clear();
+	order.clear();
+}
+/****************************************************************************/
+/*!
+\brief
+Adds a listener that is told about every dispatched event
+\param listener
+		the listener to add
+*/
+/****************************************************************************/
+void CollisionEventQueue::AddListener(CollisionListener* listener)
+{
+	listeners.push_back(listener);
+}
+/****************************************************************************/
+/*!
+\brief
+Stops a listener from being told about events
+\param listener
+		the listener to remove
+*/
+/****************************************************************************/
+void CollisionEventQueue::RemoveListener(CollisionListener* listener)
+{
+	for(std::vector<CollisionListener*>::iterator it = listeners.begin(); it != listeners.end(); ++it)
+	{
+		if(*it == listener)
+		{
+			listeners.erase(it);
+			return;
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+number of events queued. Events of the same pair are counted apart until they are dispatched
+*/
+/****************************************************************************/
+unsigned CollisionEventQueue::GetSize() const
+{
+	return events.size();
+}
+/****************************************************************************/
+/*!
+\brief
+first queued event
+*/
+/****************************************************************************/
+const CollisionEvent* CollisionEventQueue::GetBegin() const
+{
+	return events.empty() ? NULL : &events[0];
+}
+/****************************************************************************/
+/*!
+\brief
+one past the last queued event
+*/
+/****************************************************************************/
+const CollisionEvent* CollisionEventQueue::GetEnd() const
+{
+	return GetBegin() + events.size();
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "CollisionEvent.h"
+#include <vector>
+/****************************************************************************/
+/*!
+\file CollisionEventQueue.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A queue that holds the collisions of a step until they are dispatched
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class CollisionEventQueue:
+\brief
+Collects the collisions found during a step so that nothing slow like
+playing sounds happens inside the collision loop. Events between the same
+pair of bodies are merged when they are dispatched, so listeners hear about
+a pair at most once per dispatch. Events are dispatched in the order their
+pair first collided.
+*/
+/****************************************************************************/
+class CollisionEventQueue
+{
+public:
+	CollisionEventQueue(const unsigned expectedNumOfEvents = 1024);
+	~CollisionEventQueue();
+
+	void Push(const CollisionEvent& event);
+	void Dispatch();
+	void Clear();
+
+	void AddListener(CollisionListener* listener);
+	void RemoveListener(CollisionListener* listener);
+
+	unsigned GetSize() const;
+	const CollisionEvent* GetBegin() const;
+	const CollisionEvent* GetEnd() const;
+private:
+	typedef std::pair<CollisionBody*, CollisionBody*> BodyPair;
+
+	void Merge();
+
+	//events in the order they were pushed, merged into one per pair by Merge
+	std::vector<CollisionEvent> events;
+	//pair and index of every event, sorted so the events of a pair are next to each other.
+	//kept between steps along with events so pushing does not allocate once they are big enough
+	std::vector<std::pair<BodyPair, unsigned> > order;
+	std::vector<CollisionListener*> listeners;
+};
@@ -1,21 +1,33 @@
 #include "CollisionSystem.h"
 #include "timer.h"
 
+//number of pairs a worker takes at a time
+const unsigned pairsPerBatch = 4;
+
 //default constructor
 CollisionSystem::CollisionSystem()
 	:
-contactBuffer(NULL),
-contactBufferSize(9000000)
+contactBuffers(NULL),
+contactBufferSize(1000000)
 {
-	contactBuffer.SetSize(contactBufferSize);
+	const unsigned numOfWorkers = threadPool.GetNumOfWorkers();
+	contactBuffers = new MyContainer<Contact>[numOfWorkers];
+	for(unsigned worker = 0; worker < numOfWorkers; ++worker)
+	{
+		contactBuffers[worker].SetSize(contactBufferSize);
+	}
+	hits.resize(numOfWorkers);
+	numOfContacts.resize(numOfWorkers);
+	nextPair = 0;
 }
 
 //default destructor
 CollisionSystem::~CollisionSystem()
 {
+	delete [] contactBuffers;
 }
 
-void CollisionSystem::Respond(CollisionBody* body1, CollisionBody* body2, Polygonn& poly1, Polygonn& poly2)
+void CollisionSystem::Respond(CollisionBody* body1, CollisionBody* body2, Polygonn& poly1, Polygonn& poly2, CollisionEvent& event)
 {
 	//Vector3 right1 = poly2.GetNormal().Cross(body1->velocity);
 	//if(right1.IsZero())
@@ -47,58 +59,317 @@ void CollisionSystem::Respond(CollisionBody* body1, CollisionBody* body2, Polygo
 	Vector3 normal1(poly1.GetNormal());
 	Vector3 normal2(poly2.GetNormal());
 
+	if(!event.numOfHits)
+	{
+		event.point = (pos + pos2) * 0.5f;
+	}
+	++event.numOfHits;
+
+	//the bodies react to being hit when the event is dispatched, not in here
 	float test = body1->velocity.Dot(normal2);
 	if(test < 0)
 	{
 		body1->velocity -= test * normal2 * 1.5;
-		body1->RespondToCollision();
+		event.bounced1 = true;
+		if(-test > event.impact)
+		{
+			event.impact = -test;
+		}
 	}
 	test = body2->velocity.Dot(normal1);
 	if(test < 0)
 	{
 		body2->velocity -= test * normal1 * 1.5;
-		body2->RespondToCollision();
+		event.bounced2 = true;
+		if(-test > event.impact)
+		{
+			event.impact = -test;
+		}
+	}
+}
+
+//finds the root of the island the body belongs to
+unsigned CollisionSystem::FindIsland(unsigned index)
+{
+	while(islands[index] != index)
+	{
+		islands[index] = islands[islands[index]];
+		index = islands[index];
+	}
+	return index;
+}
+
+//merges the islands of two bodies that are touching each other
+void CollisionSystem::JoinIslands(unsigned index1, unsigned index2)
+{
+	unsigned root1 = FindIsland(index1);
+	unsigned root2 = FindIsland(index2);
+	if(root1 != root2)
+	{
+		islands[root2] = root1;
+	}
+}
+
+//wakes up every body that fell asleep together with the given body
+void CollisionSystem::WakeIsland(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end)
+{
+	const unsigned island = body->GetIsland();
+	for(CollisionBody* it = begin; it != end; ++it)
+	{
+		if(it->IsAsleep() && it->GetIsland() == island)
+		{
+			it->WakeUp();
+		}
 	}
 }
 
 //Update function for the interface
 void CollisionSystem::UpdateTo(const double& deltaTime, CollisionBody*const begin, CollisionBody*const end)
 {
+	const unsigned numOfBodies = end - begin;
+	islands.resize(numOfBodies);
+	for(unsigned index = 0; index < numOfBodies; ++index)
+	{
+		islands[index] = index;
+	}
+
+	//the counters cover the whole step, substeps included
+	for(unsigned worker = 0; worker < hits.size(); ++worker)
+	{
+		hits[worker].clear();
+		numOfContacts[worker] = 0;
+	}
+
+	FindPairs(begin, end);
+	CheckPairs(begin, end);
+}
+
+//collides a substepping body against the rest of the bodies as they are this step
+void CollisionSystem::UpdateSubstep(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end)
+{
+	FindPairsOf(body, begin, end);
+	CheckPairs(begin, end);
+}
+
+//checks the listed pairs on the thread pool and responds to them
+void CollisionSystem::CheckPairs(CollisionBody*const begin, CollisionBody*const end)
+{
+	if(pairs.empty())
+	{
+		return;
+	}
+	//the workers only read the trees, all the responding is done afterwards on this thread
+	nextPair = 0;
+	threadPool.Run(this);
+
+	ResolvePairs(begin, end);
+}
+
+//adds a pair of bodies to be checked
+void CollisionSystem::AddPair(CollisionBody* body1, CollisionBody* body2)
+{
+	CollisionPair pair;
+	pair.body1 = body1;
+	pair.body2 = body2;
+	pair.worker = 0;
+	pair.hitsBegin = 0;
+	pair.hitsEnd = 0;
+	pairs.push_back(pair);
+}
+
+//lists the pairs of bodies that need to be checked
+void CollisionSystem::FindPairs(CollisionBody*const begin, CollisionBody*const end)
+{
+	pairs.clear();
 	for(CollisionBody* body1 = begin; body1 != end; ++body1)
 	{
 		bool Velocity1IsZero = body1->velocity.IsZero();
 		for(CollisionBody* body2 = body1 + 1; body2 != end; ++body2)
 		{
 			bool Velocity2IsZero = body2->velocity.IsZero();
+			//sleeping bodies have their velocity zeroed so pairs of sleeping or static bodies are skipped here
 			if(Velocity1IsZero && Velocity2IsZero)
 			{
 				continue;
 			}
-			bool collisionIsDone = false;
-			
-			Contact* bufferBegin = contactBuffer.GetBegin();
-			Contact* bufferEnd = contactBuffer.GetBegin();
-			body1->tree.GetContacts(&body2->tree, bufferBegin, &bufferEnd);
-
-			//std::cout << bufferEnd - bufferBegin << std::endl;
-			for(Contact* contact = bufferBegin; contact != bufferEnd; ++contact)
+			if(body1->IsAsleep() && body2->IsAsleep())
+			{
+				continue;
+			}
+			//all the pairs are listed before any of them respond, so a pair is still checked if an earlier pair this step stopped both bodies
+			//a substepping body is checked against the others during its substeps instead.
+			//two substepping bodies are still checked here since neither is part of the other's snapshot
+			if(body1->IsSubstepping() != body2->IsSubstepping())
+			{
+				continue;
+			}
+			AddPair(body1, body2);
+		}
+	}
+}
+
+//lists the pairs of a substepping body and every body that is not substepping
+void CollisionSystem::FindPairsOf(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end)
+{
+	pairs.clear();
+	for(CollisionBody* other = begin; other != end; ++other)
+	{
+		if(other == body || other->IsSubstepping())
+		{
+			continue;
+		}
+		//keep the pair in the same order as FindPairs would so body1 is always the earlier body
+		if(other < body)
+		{
+			AddPair(other, body);
+		}
+		else
+		{
+			AddPair(body, other);
+		}
+	}
+}
+
+//runs the broad and narrow phase for the pairs a worker picks up
+void CollisionSystem::Execute(const unsigned workerIndex)
+{
+	MyContainer<Contact>& buffer = contactBuffers[workerIndex];
+	std::vector<Contact>& workerHits = hits[workerIndex];
+	const unsigned numOfPairs = pairs.size();
+
+	for(;;)
+	{
+		const unsigned first = nextPair.fetch_add(pairsPerBatch);
+		if(first >= numOfPairs)
+		{
+			break;
+		}
+		const unsigned last = first + pairsPerBatch < numOfPairs ? first + pairsPerBatch : numOfPairs;
+		for(unsigned index = first; index != last; ++index)
+		{
+			CollisionPair& pair = pairs[index];
+			pair.worker = workerIndex;
+			pair.hitsBegin = workerHits.size();
+
+			//a pair with more contacts than the buffer holds is checked again with a bigger buffer so none of them are lost
+			Contact* bufferEnd;
+			while(!pair.body1->tree.GetContacts(&pair.body2->tree, buffer.GetBegin(), &bufferEnd, buffer.GetEnd()))
 			{
-				Polygonn& poly1 = contact->node1->data;
-				Polygonn& poly2 = contact->node2->data;
+				buffer.SetSize(buffer.GetSize() * 2);
+			}
+			numOfContacts[workerIndex] += bufferEnd - buffer.GetBegin();
 
-				if(poly1.Intersects(poly2))
+			for(Contact* contact = buffer.GetBegin(); contact != bufferEnd; ++contact)
+			{
+				if(contact->node1->data.Intersects(contact->node2->data))
 				{
-					Respond(body1, body2, poly1, poly2);
-						
-					if(!collisionIsDone)
-					{
-						collisionIsDone = true;
-						body1->Decelerate(deltaTime);
-						body2->Decelerate(deltaTime);
-					}
-					//break;
+					workerHits.push_back(*contact);
 				}
 			}
+			pair.hitsEnd = workerHits.size();
+		}
+	}
+}
+
+//responds to the hits in the same order as the pairs were listed so the result does not depend on the scheduling
+void CollisionSystem::ResolvePairs(CollisionBody*const begin, CollisionBody*const end)
+{
+	for(std::vector<CollisionPair>::const_iterator pair = pairs.begin(); pair != pairs.end(); ++pair)
+	{
+		if(pair->hitsBegin == pair->hitsEnd)
+		{
+			continue;
+		}
+		CollisionBody* body1 = pair->body1;
+		CollisionBody* body2 = pair->body2;
+
+		const std::vector<Contact>& workerHits = hits[pair->worker];
+		CollisionEvent event(body1, body2);
+		for(unsigned index = pair->hitsBegin; index != pair->hitsEnd; ++index)
+		{
+			Respond(body1, body2, workerHits[index].node1->data, workerHits[index].node2->data, event);
+		}
+		events.Push(event);
+
+		//the deceleration itself is applied by the body store after all collisions are done
+		body1->AddCollision();
+		body2->AddCollision();
+
+		//a body knocked by an awake one wakes up along with everything it was resting on
+		if(body1->IsAsleep() && body1->mass)
+		{
+			WakeIsland(body1, begin, end);
+		}
+		if(body2->IsAsleep() && body2->mass)
+		{
+			WakeIsland(body2, begin, end);
+		}
+		//static bodies don't bridge islands, otherwise everything on the floor would be one island
+		if(body1->mass && body2->mass)
+		{
+			JoinIslands(body1 - begin, body2 - begin);
+		}
+	}
+}
+
+//number of broad phase contacts found during the last step
+unsigned CollisionSystem::GetNumOfContacts() const
+{
+	unsigned total = 0;
+	for(unsigned worker = 0; worker < numOfContacts.size(); ++worker)
+	{
+		total += numOfContacts[worker];
+	}
+	return total;
+}
+
+//collisions found since the last dispatch
+CollisionEventQueue& CollisionSystem::GetEvents()
+{
+	return events;
+}
+
+//number of contacts that passed the narrow phase during the last step
+unsigned CollisionSystem::GetNumOfHits() const
+{
+	unsigned total = 0;
+	for(unsigned worker = 0; worker < hits.size(); ++worker)
+	{
+		total += hits[worker].size();
+	}
+	return total;
+}
+
+//puts islands to sleep once every body in them has been resting long enough
+void CollisionSystem::UpdateSleeping(const double& deltaTime, CollisionBody*const begin, CollisionBody*const end)
+{
+	const unsigned numOfBodies = end - begin;
+	islandCanSleep.assign(numOfBodies, true);
+	islands.resize(numOfBodies);
+
+	for(CollisionBody* body = begin; body != end; ++body)
+	{
+		if(body->IsAsleep())
+		{
+			continue;
+		}
+		body->UpdateSleep(deltaTime);
+		if(!body->CanSleep())
+		{
+			islandCanSleep[FindIsland(body - begin)] = false;
+		}
+	}
+
+	for(CollisionBody* body = begin; body != end; ++body)
+	{
+		if(body->IsAsleep())
+		{
+			continue;
+		}
+		const unsigned island = FindIsland(body - begin);
+		if(islandCanSleep[island])
+		{
+			body->Sleep(island);
 		}
 	}
 }
\ No newline at end of file
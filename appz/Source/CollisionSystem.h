@@ -1,16 +1,60 @@
 #pragma once
 #include "CollisionBody.h"
 #include "MyContainer.h"
+#include "ThreadPool.h"
+#include "CollisionEventQueue.h"
+#include <atomic>
 
-class CollisionSystem
+//a pair of bodies whose trees have to be checked against each other
+class CollisionPair
+{
+public:
+	CollisionBody* body1;
+	CollisionBody* body2;
+	//the worker that checked the pair and the range of its hits in that worker's buffer
+	unsigned worker;
+	unsigned hitsBegin;
+	unsigned hitsEnd;
+};
+
+class CollisionSystem : public Task
 {
 public:
 	CollisionSystem();
 	~CollisionSystem();
-	void Respond(CollisionBody* body1, CollisionBody* body2, Polygonn& poly1, Polygonn& poly2);
+	void Respond(CollisionBody* body1, CollisionBody* body2, Polygonn& poly1, Polygonn& poly2, CollisionEvent& event);
 	void UpdateTo(const double& deltaTime, CollisionBody*const begin, CollisionBody*const end);
+	void UpdateSubstep(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end);
+	void UpdateSleeping(const double& deltaTime, CollisionBody*const begin, CollisionBody*const end);
+	virtual void Execute(const unsigned workerIndex);
+	unsigned GetNumOfContacts() const;
+	unsigned GetNumOfHits() const;
+	CollisionEventQueue& GetEvents();
 private:
-	MyContainer<Contact> contactBuffer;
+	void FindPairs(CollisionBody*const begin, CollisionBody*const end);
+	void FindPairsOf(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end);
+	void AddPair(CollisionBody* body1, CollisionBody* body2);
+	void CheckPairs(CollisionBody*const begin, CollisionBody*const end);
+	void ResolvePairs(CollisionBody*const begin, CollisionBody*const end);
+
+	void WakeIsland(CollisionBody* body, CollisionBody*const begin, CollisionBody*const end);
+	unsigned FindIsland(unsigned index);
+	void JoinIslands(unsigned index1, unsigned index2);
+
+	ThreadPool threadPool;
+	std::vector<CollisionPair> pairs;
+	std::atomic<unsigned> nextPair;
+	//each worker has its own broad phase buffer and a list of the contacts that passed the narrow phase
+	MyContainer<Contact>* contactBuffers;
+	std::vector<std::vector<Contact> > hits;
+	//number of broad phase contacts each worker found during the last step
+	std::vector<unsigned> numOfContacts;
+	//union-find parents of the bodies touching each other this frame
+	std::vector<unsigned> islands;
+	std::vector<bool> islandCanSleep;
+	//collisions found this step, dispatched once the step is over
+	CollisionEventQueue events;
 
+	//starting size of each worker's broad phase buffer, which grows when a pair has more contacts than it holds
 	unsigned contactBufferSize;
 };
\ No newline at end of file
@@ -0,0 +1,412 @@
+#include "CompressedVoxelChunk.h"
+#include <atomic>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+/****************************************************************************/
+/*!
+\file CompressedVoxelChunk.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A chunk of voxels compressed with a palette and runs along each column
+*/
+/****************************************************************************/
+
+const unsigned voxelColumnsPerChunk = voxelChunkSize * voxelChunkSize;
+//bits of a run that hold its length - 1
+const unsigned voxelRunLengthBits = 5;
+const unsigned voxelRunLengthMask = (1 << voxelRunLengthBits) - 1;
+
+//revisions are handed out from 1 counter so that a chunk made where another one was freed never has its revision
+std::atomic<unsigned> lastVoxelChunkRevision(0);
+
+/****************************************************************************/
+/*!
+\brief
+Returns whether 2 cells have the same color and solidness
+*/
+/****************************************************************************/
+static bool IsSameCell(const VoxelCell& first, const VoxelCell& second)
+{
+	return first.red == second.red && first.green == second.green && first.blue == second.blue && first.solidness == second.solidness;
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor. The chunk starts out empty
+*/
+/****************************************************************************/
+CompressedVoxelChunk::CompressedVoxelChunk()
+	:
+palette(1),
+columnStarts(voxelColumnsPerChunk + 1),
+revision(++lastVoxelChunkRevision)
+{
+	palette[0].red = 0;
+	palette[0].green = 0;
+	palette[0].blue = 0;
+	palette[0].solidness = 0;
+
+	//every column is 1 empty run as long as the column
+	runs.assign(voxelColumnsPerChunk, static_cast<unsigned short>(voxelChunkSize - 1));
+	for(unsigned column = 0; column <= voxelColumnsPerChunk; ++column)
+	{
+		columnStarts[column] = static_cast<unsigned short>(column);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+CompressedVoxelChunk::~CompressedVoxelChunk()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Replaces the chunk with cells that are not compressed
+\param cells
+		voxelsPerChunk cells ordered like the cells of a VoxelChunkFile
+*/
+/****************************************************************************/
+void CompressedVoxelChunk::Compress(const VoxelCell* cells)
+{
+	palette.resize(1);
+	runs.clear();
+
+	unsigned short materials[voxelChunkSize];
+	for(unsigned column = 0; column < voxelColumnsPerChunk; ++column)
+	{
+		const VoxelCell* columnCells = cells + column * voxelChunkSize;
+		for(int y = 0; y < voxelChunkSize; ++y)
+		{
+			//cells in a column are usually the same as the one under them
+			materials[y] = y > 0 && IsSameCell(columnCells[y], columnCells[y - 1]) ? materials[y - 1] : FindMaterial(columnCells[y]);
+		}
+		columnStarts[column] = static_cast<unsigned short>(runs.size());
+		EncodeColumn(materials, &runs);
+	}
+	columnStarts[voxelColumnsPerChunk] = static_cast<unsigned short>(runs.size());
+
+	//the vectors were sized for the chunk before so give back what is not used
+	std::vector<unsigned short>(runs).swap(runs);
+	std::vector<VoxelCell>(palette).swap(palette);
+	revision = ++lastVoxelChunkRevision;
+}
+/****************************************************************************/
+/*!
+\brief
+Writes out every cell of the chunk
+\param cells
+		where the voxelsPerChunk cells are written to, ordered like the cells
+		of a VoxelChunkFile
+*/
+/****************************************************************************/
+void CompressedVoxelChunk::Decompress(VoxelCell* cells) const
+{
+	for(unsigned column = 0; column < voxelColumnsPerChunk; ++column)
+	{
+		DecodeColumn(column, cells + column * voxelChunkSize);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Writes out the cells of a column
+\param column
+		x * voxelChunkSize + z
+\param cells
+		where the voxelChunkSize cells of the column are written to, from the
+		bottom up
+*/
+/****************************************************************************/
+void CompressedVoxelChunk::DecodeColumn(const unsigned column, VoxelCell* cells) const
+{
+	for(unsigned run = columnStarts[column]; run < columnStarts[column + 1]; ++run)
+	{
+		const VoxelCell& material = palette[runs[run] >> voxelRunLengthBits];
+		const unsigned length = (runs[run] & voxelRunLengthMask) + 1;
+		for(unsigned cell = 0; cell < length; ++cell)
+		{
+			*cells++ = material;
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Gets a cell of the chunk by walking the runs of its column. Use a
+VoxelDecodeCache to read many cells in the same columns
+\param x, y, z
+		position of the cell in the chunk
+*/
+/****************************************************************************/
+VoxelCell CompressedVoxelChunk::GetCell(const int x, const int y, const int z) const
+{
+	const unsigned column = x * voxelChunkSize + z;
+	int top = 0;
+	for(unsigned run = columnStarts[column]; run < columnStarts[column + 1]; ++run)
+	{
+		top += (runs[run] & voxelRunLengthMask) + 1;
+		if(y < top)
+		{
+			return palette[runs[run] >> voxelRunLengthBits];
+		}
+	}
+	return palette[0];
+}
+/****************************************************************************/
+/*!
+\brief
+Changes a cell of the chunk. Only the column of the cell is encoded again
+but the runs after it have to be moved, so setting many cells is faster
+done by decompressing the chunk and compressing it again. Materials that
+are no longer used stay in the palette until the chunk is compressed again
+\param x, y, z
+		position of the cell in the chunk
+\param cell
+		the new cell
+*/
+/****************************************************************************/
+void CompressedVoxelChunk::SetCell(const int x, const int y, const int z, const VoxelCell& cell)
+{
+	const unsigned column = x * voxelChunkSize + z;
+	unsigned short materials[voxelChunkSize];
+	int top = 0;
+	for(unsigned run = columnStarts[column]; run < columnStarts[column + 1]; ++run)
+	{
+		const int length = (runs[run] & voxelRunLengthMask) + 1;
+		for(int cellIndex = 0; cellIndex < length; ++cellIndex)
+		{
+			materials[top++] = runs[run] >> voxelRunLengthBits;
+		}
+	}
+
+	const unsigned short material = FindMaterial(cell);
+	if(materials[y] == material)
+	{
+		return;
+	}
+	materials[y] = material;
+
+	std::vector<unsigned short> columnRuns;
+	EncodeColumn(materials, &columnRuns);
+	const int oldSize = columnStarts[column + 1] - columnStarts[column];
+	const int newSize = static_cast<int>(columnRuns.size());
+	if(newSize > oldSize)
+	{
+		runs.insert(runs.begin() + columnStarts[column + 1], newSize - oldSize, 0);
+	}
+	else if(newSize < oldSize)
+	{
+		runs.erase(runs.begin() + columnStarts[column] + newSize, runs.begin() + columnStarts[column + 1]);
+	}
+	std::copy(columnRuns.begin(), columnRuns.end(), runs.begin() + columnStarts[column]);
+	for(unsigned after = column + 1; after <= voxelColumnsPerChunk; ++after)
+	{
+		columnStarts[after] = static_cast<unsigned short>(columnStarts[after] + newSize - oldSize);
+	}
+	revision = ++lastVoxelChunkRevision;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether every cell of the chunk is empty
+*/
+/****************************************************************************/
+bool CompressedVoxelChunk::IsEmpty() const
+{
+	for(std::vector<unsigned short>::const_iterator run = runs.begin(); run != runs.end(); ++run)
+	{
+		if(*run >> voxelRunLengthBits)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of materials in the palette, the empty material included
+*/
+/****************************************************************************/
+unsigned CompressedVoxelChunk::GetNumOfMaterials() const
+{
+	return palette.size();
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a number that changes every time the chunk is changed
+*/
+/****************************************************************************/
+unsigned CompressedVoxelChunk::GetRevision() const
+{
+	return revision;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of bytes the chunk takes
+*/
+/****************************************************************************/
+unsigned CompressedVoxelChunk::GetMemoryUsage() const
+{
+	return sizeof(CompressedVoxelChunk) +
+		palette.capacity() * sizeof(VoxelCell) +
+		columnStarts.capacity() * sizeof(unsigned short) +
+		runs.capacity() * sizeof(unsigned short);
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the material of a cell, adding it to the palette if it is not there.
+Once the palette is full the closest material is used instead
+\param cell
+		the cell to find the material of
+*/
+/****************************************************************************/
+unsigned short CompressedVoxelChunk::FindMaterial(const VoxelCell& cell)
+{
+	if(!cell.solidness)
+	{
+		return 0;
+	}
+	for(unsigned material = 1; material < palette.size(); ++material)
+	{
+		if(IsSameCell(palette[material], cell))
+		{
+			return static_cast<unsigned short>(material);
+		}
+	}
+	if(palette.size() < maxVoxelMaterials)
+	{
+		palette.push_back(cell);
+		return static_cast<unsigned short>(palette.size() - 1);
+	}
+
+	unsigned closest = 1;
+	int closestDistance = INT_MAX;
+	for(unsigned material = 1; material < palette.size(); ++material)
+	{
+		const int distance = abs(palette[material].red - cell.red) + abs(palette[material].green - cell.green) +
+			abs(palette[material].blue - cell.blue) + abs(palette[material].solidness - cell.solidness);
+		if(distance < closestDistance)
+		{
+			closest = material;
+			closestDistance = distance;
+		}
+	}
+	return static_cast<unsigned short>(closest);
+}
+/****************************************************************************/
+/*!
+\brief
+Turns the materials of a column into runs
+\param materials
+		the material of each cell in the column from the bottom up
+\param columnRuns
+		where the runs are added to
+*/
+/****************************************************************************/
+void CompressedVoxelChunk::EncodeColumn(const unsigned short* materials, std::vector<unsigned short>* columnRuns) const
+{
+	int start = 0;
+	for(int y = 1; y <= voxelChunkSize; ++y)
+	{
+		if(y == voxelChunkSize || materials[y] != materials[start])
+		{
+			columnRuns->push_back(static_cast<unsigned short>(materials[start] << voxelRunLengthBits | (y - start - 1)));
+			start = y;
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+VoxelDecodeCache::VoxelDecodeCache()
+{
+	Clear();
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+VoxelDecodeCache::~VoxelDecodeCache()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Gets a cell of a chunk, decoding its column if it is not in the cache. The
+cell stays valid until the cache reads another column
+\param chunk
+		the chunk the cell is in
+\param x, y, z
+		position of the cell in the chunk
+*/
+/****************************************************************************/
+const VoxelCell& VoxelDecodeCache::GetCell(const CompressedVoxelChunk& chunk, const int x, const int y, const int z)
+{
+	const unsigned column = x * voxelChunkSize + z;
+	//columns next to each other go in different places and so do the same columns of different chunks
+	const unsigned slot = (column ^ static_cast<unsigned>(reinterpret_cast<size_t>(&chunk) / sizeof(CompressedVoxelChunk))) % voxelDecodeCacheSize;
+	DecodedVoxelColumn& decoded = columns[slot];
+	if(decoded.chunk != &chunk || decoded.column != column || decoded.revision != chunk.GetRevision())
+	{
+		chunk.DecodeColumn(column, decoded.cells);
+		decoded.chunk = &chunk;
+		decoded.column = column;
+		decoded.revision = chunk.GetRevision();
+		++numOfMisses;
+	}
+	else
+	{
+		++numOfHits;
+	}
+	return decoded.cells[y];
+}
+/****************************************************************************/
+/*!
+\brief
+Forgets every decoded column
+*/
+/****************************************************************************/
+void VoxelDecodeCache::Clear()
+{
+	for(unsigned slot = 0; slot < voxelDecodeCacheSize; ++slot)
+	{
+		columns[slot].chunk = NULL;
+	}
+	numOfHits = 0;
+	numOfMisses = 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of cells that were read from an already decoded column
+*/
+/****************************************************************************/
+unsigned VoxelDecodeCache::GetNumOfHits() const
+{
+	return numOfHits;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of columns that had to be decoded
+*/
+/****************************************************************************/
+unsigned VoxelDecodeCache::GetNumOfMisses() const
+{
+	return numOfMisses;
+}
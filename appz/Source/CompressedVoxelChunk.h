@@ -0,0 +1,102 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file CompressedVoxelChunk.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A chunk of voxels compressed with a palette and runs along each column
+*/
+/****************************************************************************/
+#include "VoxelChunkFile.h"
+#include <vector>
+/****************************************************************************/
+/*!
+\brief
+most number of materials a compressed chunk can have, the empty material
+included
+*/
+/****************************************************************************/
+const unsigned maxVoxelMaterials = 2048;
+/****************************************************************************/
+/*!
+Class CompressedVoxelChunk:
+\brief
+A chunk of voxelChunkSize ^ 3 cells that only stores the runs of each column.
+Every different color and solidness in the chunk is a material in its
+palette, with material 0 being empty. A run is packed into 2 bytes, the
+material in the upper 11 bits and the length - 1 in the lower 5 bits, so a
+column of grass on dirt with air above it takes 6 to 8 bytes instead of the
+voxelChunkSize cells.
+
+Columns are ordered by x then z like the cells of a VoxelChunkFile, and each
+run goes up the column. A chunk with more than maxVoxelMaterials materials
+has the extra ones swapped for the closest material in its palette.
+*/
+/****************************************************************************/
+class CompressedVoxelChunk
+{
+public:
+	CompressedVoxelChunk();
+	~CompressedVoxelChunk();
+	void Compress(const VoxelCell* cells);
+	void Decompress(VoxelCell* cells) const;
+	void DecodeColumn(const unsigned column, VoxelCell* cells) const;
+	VoxelCell GetCell(const int x, const int y, const int z) const;
+	void SetCell(const int x, const int y, const int z, const VoxelCell& cell);
+	bool IsEmpty() const;
+	unsigned GetNumOfMaterials() const;
+	unsigned GetRevision() const;
+	unsigned GetMemoryUsage() const;
+private:
+	unsigned short FindMaterial(const VoxelCell& cell);
+	void EncodeColumn(const unsigned short* materials, std::vector<unsigned short>* columnRuns) const;
+
+	//palette[0] is the empty material
+	std::vector<VoxelCell> palette;
+	//where the runs of each column start, with the end of the last column after them
+	std::vector<unsigned short> columnStarts;
+	std::vector<unsigned short> runs;
+	//changes every time the chunk is changed so decoded columns know when they are stale
+	unsigned revision;
+};
+/****************************************************************************/
+/*!
+\brief
+number of columns a VoxelDecodeCache keeps decoded
+*/
+/****************************************************************************/
+const unsigned voxelDecodeCacheSize = 64;
+//a column decoded by a VoxelDecodeCache
+class DecodedVoxelColumn
+{
+public:
+	const CompressedVoxelChunk* chunk;
+	unsigned column;
+	unsigned revision;
+	VoxelCell cells[voxelChunkSize];
+};
+/****************************************************************************/
+/*!
+Class VoxelDecodeCache:
+\brief
+Keeps the last columns read from compressed chunks decoded so that reading
+cells near each other does not walk the same runs again. Each column can only
+go in 1 place in the cache, picked from its chunk and its index. A cache
+should only be used by 1 thread at a time.
+*/
+/****************************************************************************/
+class VoxelDecodeCache
+{
+public:
+	VoxelDecodeCache();
+	~VoxelDecodeCache();
+	const VoxelCell& GetCell(const CompressedVoxelChunk& chunk, const int x, const int y, const int z);
+	void Clear();
+	unsigned GetNumOfHits() const;
+	unsigned GetNumOfMisses() const;
+private:
+	DecodedVoxelColumn columns[voxelDecodeCacheSize];
+	unsigned numOfHits;
+	unsigned numOfMisses;
+};
@@ -27,7 +27,7 @@ void GLMesh::Render(const Graphics* graphics, const Mtx44& projection, const Mtx
 	graphics->BindTexture(material->texture);
 	graphics->BindMatrix(mvp);
 
-	glDrawArrays(GL_TRIANGLES, 0, GetSize()*3);
+	glDrawElements(GL_TRIANGLES, GetSize()*3, GL_UNSIGNED_INT, 0);
 }
 
 void GLMesh::Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled, const unsigned& offset, const unsigned& count) const
@@ -48,5 +48,5 @@ void GLMesh::Render(const Graphics* graphics, const Mtx44& projection, const Mtx
 	graphics->BindTexture(material->texture);
 	graphics->BindMatrix(mvp);
 
-	glDrawArrays(GL_TRIANGLES, offset, count);
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(unsigned)));
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Graphics.h"
+#include <climits>
 /****************************************************************************/
 /*!
 \file Graphics.cpp
@@ -9,6 +10,10 @@ A class that contains all of our graphics functions and handles our shader and O
 */
 /****************************************************************************/
 static const unsigned NUM_OF_LIGHT_PARAMETERS = 11;
+//the fewest packets sharing a mesh and material that are drawn instanced
+static const unsigned MIN_INSTANCES = 2;
+//first of the 4 vertex attributes that hold the model view matrix of an instance
+static const unsigned INSTANCE_ATTRIBUTE = 4;
 /****************************************************************************/
 /*!
 \brief
@@ -24,7 +29,8 @@ meshBegin(NULL),
 meshEnd(NULL),
 textureBegin(NULL),
 textureEnd(NULL),
-renderingPlane(NULL)
+renderingPlane(NULL),
+m_instanceBufferID(0)
 {
 }
 /****************************************************************************/
@@ -36,6 +42,7 @@ Default Destructor
 Graphics::~Graphics()
 {
 	ClearGFXCard();
+	glDeleteBuffers(1, &m_instanceBufferID);
 	glDeleteVertexArrays(1, &m_vertexArrayID);
 	glDeleteProgram(m_programID);
 }
@@ -82,6 +89,11 @@ void Graphics::Init(GLFWwindow* window)
 	m_parameters[U_TEXT_ENABLED] = glGetUniformLocation(m_programID, "textEnabled");
 	m_parameters[U_TEXT_COLOR] = glGetUniformLocation(m_programID, "textColor");
 	m_parameters[U_NUMLIGHTS] = glGetUniformLocation(m_programID, "numLights");
+	m_parameters[U_PROJECTION] = glGetUniformLocation(m_programID, "P");
+	m_parameters[U_INSTANCED] = glGetUniformLocation(m_programID, "instanced");
+
+	//the model view matrices of instanced draws are streamed into this every frame
+	glGenBuffers(1, &m_instanceBufferID);
 
 	for(int index = 0; index < MAX_LIGHTS; ++index)
 	{
@@ -123,6 +135,7 @@ void Graphics::Init(GLFWwindow* window)
 	}
 
 	glUseProgram(m_programID);
+	glUniform1i(m_parameters[U_INSTANCED], 0);
 
 	for(int index = 0; index < MAX_LIGHTS + 1; ++index)
 	{
@@ -137,7 +150,7 @@ unsigned Graphics::GetID(const Texture* tex) const
 	const GLTexture* texture = dynamic_cast<const GLTexture*>(tex);
 	if(texture >= textureBegin && texture < textureEnd)
 	{
-		return texture - textureBegin + 1;
+		return textureIDs[texture - textureBegin];
 	}
 
 	return 0;
@@ -148,7 +161,26 @@ unsigned Graphics::GetID(const Mesh* mesh) const
 	const GLMesh* glMesh = dynamic_cast<const GLMesh*>(mesh);
 	if(glMesh >= meshBegin && glMesh < meshEnd)
 	{
-		return glMesh - meshBegin + 1;
+		return meshIDs[glMesh - meshBegin];
+	}
+
+	return 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the name of the buffer holding the indices of a mesh, 0 if the mesh
+was not sent to the graphics card
+\param mesh
+		the mesh to look up
+*/
+/****************************************************************************/
+unsigned Graphics::GetIndexBufferID(const Mesh* mesh) const
+{
+	const GLMesh* glMesh = dynamic_cast<const GLMesh*>(mesh);
+	if(glMesh >= meshBegin && glMesh < meshEnd)
+	{
+		return indexBufferIDs[glMesh - meshBegin];
 	}
 
 	return 0;
@@ -319,16 +351,47 @@ void Graphics::RenderDraw(const DrawOrder& object, const Mtx44& matrix)
 	RenderMesh(object.geometry, ID, GL_TRIANGLES);
 }
 
+/****************************************************************************/
+/*!
+\brief
+Sends meshes to the graphics card with their vertices welded and their
+triangles drawn through an index buffer. Triangles are reordered to make
+better use of the vertex cache, except for the text mesh whose characters
+are drawn as ranges of its triangles. InitText has to be called first so
+the text mesh is known
+\param begin
+		the first mesh to send
+\param end
+		one past the last mesh to send
+*/
+/****************************************************************************/
 void Graphics::SendMeshInfo(GLMesh* begin, GLMesh* end)
 {
 	meshBegin = begin;
 	meshEnd = end;
+	meshIDs.resize(end - begin);
+	indexBufferIDs.resize(end - begin);
+	std::vector<Vertex> vertices;
+	std::vector<unsigned> indices;
 	for(GLMesh* mesh = begin; mesh != end; ++mesh)
 	{
-		unsigned ID = 0;
+		mesh->UpdateBoundingBox();
+
+		MeshBuilder::GenerateIndices(mesh, &vertices, &indices);
+		if(!meshText || meshText->geometry != mesh)
+		{
+			MeshBuilder::ReorderForVertexCache(&vertices, &indices);
+		}
+
+		unsigned& ID = meshIDs[mesh - begin];
 		glGenBuffers(1, &ID);
 		glBindBuffer(GL_ARRAY_BUFFER, ID);
-		glBufferData(GL_ARRAY_BUFFER, mesh->GetSize() * sizeof(Vertex) * 3, mesh->GetBegin(), GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.empty() ? NULL : &vertices[0], GL_STATIC_DRAW);
+
+		unsigned& indexBufferID = indexBufferIDs[mesh - begin];
+		glGenBuffers(1, &indexBufferID);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned), indices.empty() ? NULL : &indices[0], GL_STATIC_DRAW);
 	}
 }
 
@@ -336,9 +399,10 @@ void Graphics::SendTextureInfo(GLTexture* begin, GLTexture* end)
 {
 	textureBegin = begin;
 	textureEnd = end;
+	textureIDs.resize(end - begin);
 	for(GLTexture* tex = begin; tex != end; ++tex)
 	{
-		unsigned ID = 0;
+		unsigned& ID = textureIDs[tex - begin];
 		glGenTextures(1, &ID);
 		glBindTexture(GL_TEXTURE_2D, ID);
 
@@ -360,17 +424,20 @@ void Graphics::SendTextureInfo(GLTexture* begin, GLTexture* end)
 
 void Graphics::ClearGFXCard()
 {
-	unsigned id = 0;
-	for(GLMesh* mesh = meshBegin; mesh != meshEnd; ++mesh, ++id)
+	if(!meshIDs.empty())
 	{
-		glDeleteBuffers(1, &id);
+		glDeleteBuffers(meshIDs.size(), &meshIDs[0]);
+		glDeleteBuffers(indexBufferIDs.size(), &indexBufferIDs[0]);
+		meshIDs.clear();
+		indexBufferIDs.clear();
 	}
-
-	id = 0;
-	for(GLTexture* tex = textureBegin; tex != textureEnd; ++tex, ++id)
+	if(!textureIDs.empty())
 	{
-		glDeleteTextures(1, &id);
+		glDeleteTextures(textureIDs.size(), &textureIDs[0]);
+		textureIDs.clear();
 	}
+	meshBegin = meshEnd = NULL;
+	textureBegin = textureEnd = NULL;
 }
 
 void Graphics::BindTexture(const Texture* texture) const
@@ -391,8 +458,21 @@ void Graphics::BindTexture(const Texture* texture) const
 
 void Graphics::BindMesh(const Mesh* mesh) const
 {
-	const unsigned meshID = GetID(mesh);
-	glBindBuffer(GL_ARRAY_BUFFER, meshID);
+	BindVertexBuffer(mesh);
+}
+/****************************************************************************/
+/*!
+\brief
+Binds the vertex and index buffers of a mesh and points the vertex
+attributes at them
+\param mesh
+		the mesh to bind
+*/
+/****************************************************************************/
+void Graphics::BindVertexBuffer(const Mesh* mesh) const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, GetID(mesh));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GetIndexBufferID(mesh));
 
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(Vector3));
@@ -632,16 +712,9 @@ void Graphics::RenderMesh(const Mesh* mesh, const unsigned textureID, const unsi
 	{
 		throw;
 	}
-	unsigned ID = GetID(mesh);
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
-
+	BindVertexBuffer(mesh);
 	glBindTexture(GL_TEXTURE_2D, textureID);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(Vector3));
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color)));
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color) + sizeof(Vector3)));
-	glDrawArrays(mode, 0, mesh->GetSize()*3);
+	glDrawElements(mode, mesh->GetSize() * 3, GL_UNSIGNED_INT, 0);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -650,9 +723,10 @@ void Graphics::RenderMesh(const Mesh* mesh, const unsigned textureID, const unsi
 \brief
 renders a portion of the mesh
 \param offset
-		the offset to the first vertex in the vertex buffer to be rendered
+		the offset to the first index in the index buffer to be rendered,
+		which is the same as the first vertex of the polygons to be rendered
 \param count
-		the number of vertices to be rendered after the first
+		the number of indices to be rendered after the first
 \param textureID
 		the id of the texture we will render the mesh with
 \param mode
@@ -661,40 +735,221 @@ renders a portion of the mesh
 /****************************************************************************/
 void Graphics::RenderMesh(const Mesh* mesh, const unsigned offset, const unsigned count, const unsigned textureID, const unsigned mode)
 {
-	unsigned ID = GetID(mesh);
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
-
+	BindVertexBuffer(mesh);
 	glBindTexture(GL_TEXTURE_2D, textureID);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(Vector3));
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color)));
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color) + sizeof(Vector3)));
-	glDrawArrays(mode, offset, count);
+	glDrawElements(mode, count, GL_UNSIGNED_INT, (void*)(offset * sizeof(unsigned)));
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 /****************************************************************************/
 /*!
 \brief
-Tells OpenGL to draw itself and it's children
+Draws a DrawOrder and its children, sorted so that the ones sharing a
+shader state, texture and mesh are drawn together
+\param draw
+		the DrawOrder at the top of the hierarchy
 */
 /****************************************************************************/
 void Graphics::RenderDraw(const DrawOrder* draw)
 {
+	QueueDraw(draw);
+	SubmitQueue();
+}
+/****************************************************************************/
+/*!
+\brief
+Adds the parts of a DrawOrder and its children that the camera can see to
+the render queue without drawing anything. DrawOrders whose bounds were
+never worked out by UpdateBounds are not culled
+\param draw
+		the DrawOrder at the top of the hierarchy
+*/
+/****************************************************************************/
+void Graphics::QueueDraw(const DrawOrder* draw)
+{
+	frustum.SetTo(projectionStack.Top() * viewStack.Top());
+	QueueVisibleDraws(draw);
+}
+/****************************************************************************/
+/*!
+\brief
+Adds a DrawOrder and its children to the render queue unless their bounds
+are outside of the frustum, in which case the whole subtree is skipped.
+Empty bounds are not culled since they may have never been worked out.
+The DrawOrders are placed by their cached matrices so nothing is multiplied
+for the ones that did not move
+\param draw
+		the DrawOrder to queue
+*/
+/****************************************************************************/
+void Graphics::QueueVisibleDraws(const DrawOrder* draw)
+{
+	//the bounds are in the space of the parent. A subtree that really has nothing to draw adds nothing either way
+	const MeshBox bounds = draw->GetParent() ? TransformMeshBox(draw->GetBounds(), draw->GetParent()->GetModelTransform()) : draw->GetBounds();
+	if(!bounds.IsEmpty() && !frustum.IsOverlapping(Vector3(bounds.rangeX.start, bounds.rangeY.start, bounds.rangeZ.start), Vector3(bounds.rangeX.end, bounds.rangeY.end, bounds.rangeZ.end)))
+	{
+		return;
+	}
+
 	for(std::vector<DrawOrder*>::const_iterator child = draw->GetChildrenVector().begin(), end = draw->GetChildrenVector().end(); child != end; child++)
 	{
-		modelStack.PushMatrix();
-		modelStack.MultMatrix(draw->transform.TranslationMatrix() * draw->transform.RotationMatrix() * draw->transform.ScalationMatrix());
-		RenderDraw(*child);
+		QueueVisibleDraws(*child);
 	}
+
 	//a small check to see weather the draw order is pointing to a geometry before drawing it.
-	if(draw->geometry)
+	RenderPacket packet;
+	packet.meshID = draw->geometry ? GetID(draw->geometry) : 0;
+	if(!packet.meshID)
+	{
+		return;
+	}
+	packet.draw = draw;
+	packet.model = draw->GetMatrix();
+	packet.textureID = GetID(draw->material->texture);
+
+	//the camera looks down -z so the depth is how far the origin of the model is along -z
+	const Mtx44 modelView = viewStack.Top() * packet.model;
+	renderQueue.Add(packet, -modelView.a[14]);
+}
+/****************************************************************************/
+/*!
+\brief
+Sorts the render queue and draws it, only changing the lighting, material,
+texture and vertex buffer when they differ from the packet before. Runs of
+packets sharing a mesh, material and lighting are drawn with a single
+instanced draw call
+*/
+/****************************************************************************/
+void Graphics::SubmitQueue()
+{
+	renderQueue.Sort();
+
+	glActiveTexture(GL_TEXTURE0);
+	glUniform1i(m_parameters[U_COLOR_TEXTURE], 0);
+	glUniformMatrix4fv(m_parameters[U_PROJECTION], 1, GL_FALSE, &projectionStack.Top().a[0]);
+
+	//nothing is bound yet so the first packet sets everything
+	int boundLighting = -1;
+	const Material* boundMaterial = NULL;
+	unsigned boundTexture = UINT_MAX;
+	unsigned boundMesh = 0;
+	bool instanced = false;
+	for(unsigned index = 0; index < renderQueue.GetSize();)
+	{
+		const RenderPacket& packet = renderQueue.GetPacket(index);
+		const DrawOrder& object = *packet.draw;
+
+		//packets in the same run look the same apart from where they are
+		unsigned runEnd = index + 1;
+		while(runEnd < renderQueue.GetSize())
+		{
+			const RenderPacket& next = renderQueue.GetPacket(runEnd);
+			if(next.meshID != packet.meshID || next.draw->material != object.material || next.draw->enableLight != object.enableLight)
+			{
+				break;
+			}
+			++runEnd;
+		}
+		const unsigned numOfInstances = runEnd - index >= MIN_INSTANCES ? runEnd - index : 1;
+
+		if(boundLighting != static_cast<int>(object.enableLight))
+		{
+			boundLighting = object.enableLight;
+			glUniform1i(m_parameters[U_LIGHTENABLED], boundLighting);
+		}
+		if(object.enableLight && object.material != boundMaterial)
+		{
+			boundMaterial = object.material;
+			glUniform3fv(m_parameters[U_MATERIAL_AMBIENT], 1, &boundMaterial->kAmbient.r);
+			glUniform3fv(m_parameters[U_MATERIAL_DIFFUSE], 1, &boundMaterial->kDiffuse.r);
+			glUniform3fv(m_parameters[U_MATERIAL_SPECULAR], 1, &boundMaterial->kSpecular.r);
+			glUniform1f(m_parameters[U_MATERIAL_SHININESS], boundMaterial->kShininess);
+		}
+		if(packet.textureID != boundTexture)
+		{
+			boundTexture = packet.textureID;
+			glBindTexture(GL_TEXTURE_2D, boundTexture);
+			glUniform1i(m_parameters[U_COLOR_TEXTURE_ENABLED], boundTexture ? 1 : 0);
+		}
+		if(packet.meshID != boundMesh)
+		{
+			boundMesh = packet.meshID;
+			BindVertexBuffer(object.geometry);
+		}
+
+		if(numOfInstances > 1)
+		{
+			if(!instanced)
+			{
+				instanced = true;
+				glUniform1i(m_parameters[U_INSTANCED], 1);
+			}
+			DrawInstances(index, numOfInstances);
+			index += numOfInstances;
+			continue;
+		}
+		if(instanced)
+		{
+			instanced = false;
+			glUniform1i(m_parameters[U_INSTANCED], 0);
+		}
+
+		const Mtx44 modelView = viewStack.Top() * packet.model;
+		const Mtx44 MVP = projectionStack.Top() * modelView;
+		glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
+		if(object.enableLight)
+		{
+			glUniformMatrix4fv(m_parameters[U_MODELVIEW], 1, GL_FALSE, &modelView.a[0]);
+			const Mtx44 modelView_inverse_transpose = modelView.GetInverse().GetTranspose();
+			glUniformMatrix4fv(m_parameters[U_MODELVIEW_INVERSE_TRANSPOSE], 1, GL_FALSE, &modelView_inverse_transpose.a[0]);
+		}
+		glDrawElements(GL_TRIANGLES, object.geometry->GetSize() * 3, GL_UNSIGNED_INT, 0);
+		++index;
+	}
+
+	if(instanced)
 	{
-		modelStack.PushMatrix();
-		modelStack.MultMatrix(draw->transform.TranslationMatrix() * draw->selfTransform.TranslationMatrix() * draw->transform.RotationMatrix() * draw->selfTransform.RotationMatrix() * draw->transform.ScalationMatrix() * draw->selfTransform.ScalationMatrix());
-		RenderDraw(*draw, modelStack.Top());
-		modelStack.PopMatrix();
+		glUniform1i(m_parameters[U_INSTANCED], 0);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	renderQueue.Clear();
+}
+/****************************************************************************/
+/*!
+\brief
+Uploads the model view matrices of a run of packets into the instance
+buffer and draws them all at once. The mesh, texture and material of the
+run have to be bound already
+\param first
+		position of the first packet of the run in the render queue
+\param numOfInstances
+		number of packets in the run
+*/
+/****************************************************************************/
+void Graphics::DrawInstances(const unsigned first, const unsigned numOfInstances)
+{
+	instanceMatrices.resize(numOfInstances);
+	for(unsigned instance = 0; instance < numOfInstances; ++instance)
+	{
+		instanceMatrices[instance] = viewStack.Top() * renderQueue.GetPacket(first + instance).model;
+	}
+
+	//the attributes remember the buffer they were pointed at so the mesh stays bound to attributes 0 to 3
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBufferID);
+	glBufferData(GL_ARRAY_BUFFER, numOfInstances * sizeof(Mtx44), &instanceMatrices[0], GL_STREAM_DRAW);
+	for(unsigned column = 0; column < 4; ++column)
+	{
+		glEnableVertexAttribArray(INSTANCE_ATTRIBUTE + column);
+		glVertexAttribPointer(INSTANCE_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(Mtx44), (void*)(column * 4 * sizeof(float)));
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE + column, 1);
+	}
+
+	const RenderPacket& packet = renderQueue.GetPacket(first);
+	glDrawElementsInstanced(GL_TRIANGLES, packet.draw->geometry->GetSize() * 3, GL_UNSIGNED_INT, 0, numOfInstances);
+
+	for(unsigned column = 0; column < 4; ++column)
+	{
+		glDisableVertexAttribArray(INSTANCE_ATTRIBUTE + column);
 	}
 }
 void Graphics::BeginDrawing() const
@@ -747,16 +1002,9 @@ void Graphics::RenderPixels(Color* buffer, Mesh* plane, unsigned sizeX, unsigned
 	glUniform1i(m_parameters[U_COLOR_TEXTURE], 0);
 
 	glUniformMatrix4fv(m_parameters[U_MVP], 1, GL_FALSE, &MVP.a[0]);
-	unsigned ID = GetID(plane);
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
-
+	BindVertexBuffer(plane);
 	glBindTexture(GL_TEXTURE_2D, texture);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(Vector3));
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color)));
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(Vector3) + sizeof(Color) + sizeof(Vector3)));
-	glDrawArrays(GL_TRIANGLES, 0, plane->GetSize());
+	glDrawElements(GL_TRIANGLES, plane->GetSize() * 3, GL_UNSIGNED_INT, 0);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
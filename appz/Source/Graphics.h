@@ -18,6 +18,9 @@ A class that contains all of our graphics functions and handles our shader and O
 #include "DrawOrder.h"
 #include "GLMesh.h"
 #include "GLTexture.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "MeshBuilder.h"
 /****************************************************************************/
 /*!
 \brief
@@ -76,6 +79,8 @@ public:
 	void RenderMeshOnScreen(const DrawOrder& object, const Mtx44& matrix, const ORIENTATION orientation = ORIENTATION_BOTTOM);
 	void RenderDraw(const DrawOrder& object, const Mtx44& Matrix);
 	void RenderDraw(const DrawOrder* draw);
+	void QueueDraw(const DrawOrder* draw);
+	void SubmitQueue();
 	void RenderMesh(const Mesh* mesh, const unsigned offset, const unsigned count, const unsigned textureID, const unsigned mode);
 	void RenderMesh(const Mesh* mesh, const unsigned textureID, const unsigned mode);
 
@@ -91,6 +96,11 @@ public:
 	unsigned GetID(const Texture* tex) const;
 	unsigned GetID(const Mesh* mesh) const;
 private:
+	void BindVertexBuffer(const Mesh* mesh) const;
+	unsigned GetIndexBufferID(const Mesh* mesh) const;
+	void QueueVisibleDraws(const DrawOrder* draw);
+	void DrawInstances(const unsigned first, const unsigned numOfInstances);
+
 	enum UNIFORM_TYPE
 	{
 		U_MVP = 0,
@@ -105,6 +115,8 @@ private:
 		U_TEXT_ENABLED,
 		U_COLOR_ENABLED,
 		U_TEXT_COLOR,
+		U_PROJECTION,
+		U_INSTANCED,
 
 		U_LIGHTENABLED,
 		U_NUMLIGHTS,
@@ -221,7 +233,19 @@ private:
 	GLTexture* textureBegin;
 	GLTexture* textureEnd;
 
+	//the names OpenGL gave the buffers of each mesh and each texture
+	std::vector<unsigned> meshIDs;
+	std::vector<unsigned> indexBufferIDs;
+	std::vector<unsigned> textureIDs;
+
 	MS viewStack, modelStack, projectionStack;
 
 	Mesh* renderingPlane;
+
+	//what RenderDraw collects before drawing it all in order of state
+	RenderQueue renderQueue;
+	//what the camera can see while a DrawOrder is being queued
+	Frustum frustum;
+	unsigned m_instanceBufferID;
+	std::vector<Mtx44> instanceMatrices;
 };
\ No newline at end of file
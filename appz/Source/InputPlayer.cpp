@@ -0,0 +1,118 @@
+#include "InputPlayer.h"
+#include <cstring>
+/****************************************************************************/
+/*!
+\file InputPlayer.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that plays back a recording made by InputRecorder
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+InputPlayer::InputPlayer()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+InputPlayer::~InputPlayer()
+{
+	Close();
+}
+/****************************************************************************/
+/*!
+\brief
+Opens a recording and checks its header
+\param path
+		the recording to be played
+\return
+		if the file is a recording this version can play
+*/
+/****************************************************************************/
+bool InputPlayer::Open(const std::string& path)
+{
+	Close();
+	file.open(path.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	char magic[sizeof(recordingMagic)];
+	unsigned version = 0;
+	file.read(magic, sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	if(!file || memcmp(magic, recordingMagic, sizeof(magic)) != 0 || version != recordingVersion)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Reads the next frame and hands its input to the keyboard and mouse
+\param deltaTime
+		where the timestep of the frame is stored
+\param keyboard
+		keyboard that receives the key states
+\param mouse
+		mouse that receives the mouse state
+\return
+		false once there are no more frames
+*/
+/****************************************************************************/
+bool InputPlayer::ReadFrame(double* deltaTime, ReplayKeyboard* keyboard, ReplayMouse* mouse)
+{
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	unsigned char keys[32];
+	float mouseState[4];
+	unsigned char buttons;
+
+	file.read(reinterpret_cast<char*>(deltaTime), sizeof(*deltaTime));
+	file.read(reinterpret_cast<char*>(keys), sizeof(keys));
+	file.read(reinterpret_cast<char*>(mouseState), sizeof(mouseState));
+	file.read(reinterpret_cast<char*>(&buttons), sizeof(buttons));
+	if(!file)
+	{
+		return false;
+	}
+
+	bool keysDown[256];
+	for(unsigned key = 0; key < 256; ++key)
+	{
+		keysDown[key] = (keys[key >> 3] & (1 << (key & 7))) != 0;
+	}
+	keyboard->SetKeysDown(keysDown);
+	mouse->SetNextState(Vector2(mouseState[0], mouseState[1]), Vector2(mouseState[2], mouseState[3]), (buttons & (1 << Mouse::LEFT)) != 0, (buttons & (1 << Mouse::RIGHT)) != 0);
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Closes the recording
+*/
+/****************************************************************************/
+void InputPlayer::Close()
+{
+	if(file.is_open())
+	{
+		file.close();
+	}
+	file.clear();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include "InputRecorder.h"
+#include "ReplayKeyboard.h"
+#include "ReplayMouse.h"
+/****************************************************************************/
+/*!
+\file InputPlayer.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that plays back a recording made by InputRecorder
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class InputPlayer:
+\brief
+reads back the frames of a recording made by InputRecorder and feeds them
+to a ReplayKeyboard and ReplayMouse
+*/
+/****************************************************************************/
+class InputPlayer
+{
+public:
+	InputPlayer();
+	~InputPlayer();
+	bool Open(const std::string& path);
+	bool ReadFrame(double* deltaTime, ReplayKeyboard* keyboard, ReplayMouse* mouse);
+	void Close();
+private:
+	std::ifstream file;
+};
@@ -0,0 +1,119 @@
+#include "InputRecorder.h"
+/****************************************************************************/
+/*!
+\file InputRecorder.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that records the input and timestep of every frame to a file
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+InputRecorder::InputRecorder()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+InputRecorder::~InputRecorder()
+{
+	Close();
+}
+/****************************************************************************/
+/*!
+\brief
+Creates the recording and writes its header
+\param path
+		where the recording is saved
+\return
+		if the file could be opened
+*/
+/****************************************************************************/
+bool InputRecorder::Open(const std::string& path)
+{
+	Close();
+	file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!file.is_open())
+	{
+		return false;
+	}
+	file.write(recordingMagic, sizeof(recordingMagic));
+	file.write(reinterpret_cast<const char*>(&recordingVersion), sizeof(recordingVersion));
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the input of a frame to the recording
+\param deltaTime
+		timestep of the frame
+\param keyboard
+		keyboard after it has been updated for the frame
+\param mouse
+		mouse after it has been updated for the frame
+*/
+/****************************************************************************/
+void InputRecorder::RecordFrame(const double deltaTime, const Keyboard& keyboard, const FirstPersonMouse& mouse)
+{
+	if(!file.is_open())
+	{
+		return;
+	}
+
+	unsigned char keys[32] = {0};
+	for(unsigned short key = 0; key < 256; ++key)
+	{
+		if(keyboard.IsKeyDown(key))
+		{
+			keys[key >> 3] |= 1 << (key & 7);
+		}
+	}
+
+	const float mouseState[4] = {mouse.GetPosition().x, mouse.GetPosition().y, mouse.GetCentre().x, mouse.GetCentre().y};
+	unsigned char buttons = 0;
+	if(mouse.LeftMouseHold())
+	{
+		buttons |= 1 << Mouse::LEFT;
+	}
+	if(mouse.RightMouseHold())
+	{
+		buttons |= 1 << Mouse::RIGHT;
+	}
+
+	file.write(reinterpret_cast<const char*>(&deltaTime), sizeof(deltaTime));
+	file.write(reinterpret_cast<const char*>(keys), sizeof(keys));
+	file.write(reinterpret_cast<const char*>(mouseState), sizeof(mouseState));
+	file.write(reinterpret_cast<const char*>(&buttons), sizeof(buttons));
+}
+/****************************************************************************/
+/*!
+\brief
+Finishes the recording
+*/
+/****************************************************************************/
+void InputRecorder::Close()
+{
+	if(file.is_open())
+	{
+		file.close();
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns if a recording is in progress
+*/
+/****************************************************************************/
+bool InputRecorder::IsOpen() const
+{
+	return file.is_open();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include "Keyboard.h"
+#include "FirstPersonMouse.h"
+/****************************************************************************/
+/*!
+\file InputRecorder.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that records the input and timestep of every frame to a file
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+the first bytes of every recording, followed by recordingVersion
+*/
+/****************************************************************************/
+const char recordingMagic[4] = {'P', '3', 'D', 'R'};
+const unsigned recordingVersion = 1;
+/****************************************************************************/
+/*!
+Class InputRecorder:
+\brief
+records the input and timestep of every frame to a binary file so that a
+run can be played back exactly. Each frame is stored as
+	double		deltaTime
+	32 bytes	one bit for every key that is down
+	4 floats	mouse position x, y and window centre x, y
+	1 byte		mouse buttons that are down, one bit each
+*/
+/****************************************************************************/
+class InputRecorder
+{
+public:
+	InputRecorder();
+	~InputRecorder();
+	bool Open(const std::string& path);
+	void RecordFrame(const double deltaTime, const Keyboard& keyboard, const FirstPersonMouse& mouse);
+	void Close();
+	bool IsOpen() const;
+private:
+	std::ofstream file;
+};
@@ -1,6 +1,11 @@
 #include <vector>
 #include "MeshBuilder.h"
 #include "LoadOBJ.h"
+#include "VoxelHashGrid.h"
+#include <algorithm>
+#include <map>
+#include <climits>
+#include <cmath>
 /****************************************************************************/
 /*!
 \file MeshBuilder.cpp
@@ -148,4 +153,472 @@ void MeshBuilder::GenerateText(Mesh* mesh, const unsigned& numRow, const unsigne
 		TopLeft.y -= decrementV;
 		TopRight.y -= decrementV;
 	}
-}
\ No newline at end of file
+}
+/****************************************************************************/
+/*!
+Class VoxelFace:
+\brief
+A side of a voxel that is not covered by another voxel. Positions are
+given along the axis the face points at (slice) and the 2 axes that come
+after it (u and v) so that faces in the same plane can be merged
+*/
+/****************************************************************************/
+class VoxelFace
+{
+public:
+	bool operator<(const VoxelFace& face) const
+	{
+		if(slice != face.slice)
+		{
+			return slice < face.slice;
+		}
+		if(v != face.v)
+		{
+			return v < face.v;
+		}
+		return u < face.u;
+	}
+
+	int slice;
+	int u;
+	int v;
+	Color color;
+};
+/****************************************************************************/
+/*!
+\brief
+Returns whether 2 faces can be merged into the same quad
+*/
+/****************************************************************************/
+static bool IsSameColor(const Color& color1, const Color& color2)
+{
+	return color1.r == color2.r && color1.g == color2.g && color1.b == color2.b;
+}
+/****************************************************************************/
+/*!
+\brief
+Finds a face in a sorted range of faces of the same slice
+\param faces
+		the faces sorted by slice, v then u
+\param begin
+		first face of the slice
+\param end
+		one past the last face of the slice
+\param v
+		position of the face along v
+\param u
+		position of the face along u
+\return
+		index of the face, or -1 if there is no face there
+*/
+/****************************************************************************/
+static int FindFace(const std::vector<VoxelFace>& faces, const unsigned begin, const unsigned end, const int v, const int u)
+{
+	VoxelFace key;
+	key.slice = faces[begin].slice;
+	key.u = u;
+	key.v = v;
+	std::vector<VoxelFace>::const_iterator found = std::lower_bound(faces.begin() + begin, faces.begin() + end, key);
+	if(found == faces.begin() + end || found->v != v || found->u != u)
+	{
+		return -1;
+	}
+	return found - faces.begin();
+}
+/****************************************************************************/
+/*!
+\brief
+Generates a mesh from voxels. Only the faces of voxels that are not covered
+by another voxel are kept, and faces in the same plane with the same color
+are merged into as few quads as possible. Every voxel is taken to be a
+cube of size 1 centred on its position, like the cube mesh. Voxels with no
+solidness are left out.
+\param mesh
+		the mesh to be filled
+\param voxels
+		the voxels to generate the mesh from
+*/
+/****************************************************************************/
+void MeshBuilder::GenerateVoxelMesh(Mesh* mesh, const std::vector<Voxel*>& voxels)
+{
+	VoxelHashGrid grid(voxels.size());
+	for(std::vector<Voxel*>::const_iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+	{
+		grid.AddVoxel(**voxel);
+	}
+
+	std::vector<Polygonn> polygons;
+	std::vector<VoxelFace> faces;
+	std::vector<bool> merged;
+	faces.reserve(voxels.size());
+
+	//one pass for every direction a face can point at
+	for(unsigned direction = 0; direction < 6; ++direction)
+	{
+		const unsigned axis = direction / 2;
+		const int sign = direction % 2 ? -1 : 1;
+		const unsigned axisU = (axis + 1) % 3;
+		const unsigned axisV = (axis + 2) % 3;
+
+		faces.clear();
+		for(std::vector<Voxel*>::const_iterator voxel = voxels.begin(); voxel != voxels.end(); ++voxel)
+		{
+			//the grid only holds solid voxels so empty ones would be walled in by their neighbours
+			if(!(*voxel)->GetSolidness())
+			{
+				continue;
+			}
+			const Vector3 position = (*voxel)->GetPosition();
+			const int coordinates[3] = {static_cast<int>(position.x), static_cast<int>(position.y), static_cast<int>(position.z)};
+			int neighbour[3] = {coordinates[0], coordinates[1], coordinates[2]};
+			neighbour[axis] += sign;
+			if(grid.GetVoxel(Vector3(static_cast<float>(neighbour[0]), static_cast<float>(neighbour[1]), static_cast<float>(neighbour[2]))))
+			{
+				continue;
+			}
+
+			VoxelFace face;
+			face.slice = coordinates[axis];
+			face.u = coordinates[axisU];
+			face.v = coordinates[axisV];
+			face.color = (*voxel)->GetColor();
+			faces.push_back(face);
+		}
+		std::sort(faces.begin(), faces.end());
+
+		Vector3 normal;
+		(&normal.x)[axis] = static_cast<float>(sign);
+
+		//merge the faces of one slice at a time. Faces are looked up in the sorted list instead of laid out on a
+		//grid of the slice so that faces far apart in the same slice cost no more than faces next to each other
+		merged.assign(faces.size(), false);
+		unsigned sliceBegin = 0;
+		while(sliceBegin != faces.size())
+		{
+			const int slice = faces[sliceBegin].slice;
+			unsigned sliceEnd = sliceBegin;
+			while(sliceEnd != faces.size() && faces[sliceEnd].slice == slice)
+			{
+				++sliceEnd;
+			}
+
+			for(unsigned index = sliceBegin; index != sliceEnd; ++index)
+			{
+				if(merged[index])
+				{
+					continue;
+				}
+				const VoxelFace& face = faces[index];
+				const Color& color = face.color;
+
+				//grow the quad along u as far as it can go, then along v for as long as the whole row matches.
+				//faces next to each other along u are next to each other in the list
+				int quadWidth = 1;
+				while(index + quadWidth < sliceEnd && faces[index + quadWidth].v == face.v && faces[index + quadWidth].u == face.u + quadWidth &&
+					!merged[index + quadWidth] && IsSameColor(faces[index + quadWidth].color, color))
+				{
+					++quadWidth;
+				}
+				int quadHeight = 1;
+				for(;; ++quadHeight)
+				{
+					const int rowStart = FindFace(faces, sliceBegin, sliceEnd, face.v + quadHeight, face.u);
+					bool rowMatches = rowStart >= 0;
+					for(int offset = 0; offset < quadWidth && rowMatches; ++offset)
+					{
+						const unsigned next = rowStart + offset;
+						rowMatches = next < sliceEnd && faces[next].v == face.v + quadHeight && faces[next].u == face.u + offset &&
+							!merged[next] && IsSameColor(faces[next].color, color);
+					}
+					if(!rowMatches)
+					{
+						break;
+					}
+				}
+				for(int row = 0; row < quadHeight; ++row)
+				{
+					const unsigned rowStart = row ? FindFace(faces, sliceBegin, sliceEnd, face.v + row, face.u) : index;
+					for(int offset = 0; offset < quadWidth; ++offset)
+					{
+						merged[rowStart + offset] = true;
+					}
+				}
+
+				//corners of the quad, the face sits half a voxel out from the centre of its voxels
+				Vertex corners[4];
+				const float u0 = face.u - 0.5f, u1 = u0 + quadWidth;
+				const float v0 = face.v - 0.5f, v1 = v0 + quadHeight;
+				const float cornerU[4] = {u0, u1, u1, u0};
+				const float cornerV[4] = {v0, v0, v1, v1};
+				for(unsigned corner = 0; corner < 4; ++corner)
+				{
+					float position[3];
+					position[axis] = slice + sign * 0.5f;
+					position[axisU] = cornerU[corner];
+					position[axisV] = cornerV[corner];
+					corners[corner].Set(Vector3(position[0], position[1], position[2]), color, normal, Vector2(cornerU[corner] - u0, cornerV[corner] - v0));
+				}
+
+				//u cross v points along the axis so faces pointing the other way are wound backwards
+				if(sign > 0)
+				{
+					polygons.push_back(Polygonn(corners[0], corners[1], corners[2]));
+					polygons.push_back(Polygonn(corners[0], corners[2], corners[3]));
+				}
+				else
+				{
+					polygons.push_back(Polygonn(corners[0], corners[2], corners[1]));
+					polygons.push_back(Polygonn(corners[0], corners[3], corners[2]));
+				}
+			}
+			sliceBegin = sliceEnd;
+		}
+	}
+
+	mesh->SetSize(polygons.size());
+	std::copy(polygons.begin(), polygons.end(), mesh->GetBegin());
+}
+/****************************************************************************/
+/*!
+\brief
+Welds the vertices of a mesh that are exactly the same and lists the
+triangles as indices into them, in the same order as the polygons
+\param mesh
+		the mesh to weld
+\param vertices
+		where the welded vertices are written to
+\param indices
+		where 3 indices for each polygon are written to
+*/
+/****************************************************************************/
+void MeshBuilder::GenerateIndices(const Mesh* mesh, std::vector<Vertex>* vertices, std::vector<unsigned>* indices)
+{
+	vertices->clear();
+	indices->clear();
+	indices->reserve(mesh->GetSize() * 3);
+
+	std::map<Vertex, unsigned> welded;
+	for(const Vertex* vertex = &mesh->GetBegin()->vertex1, *end = &mesh->GetEnd()->vertex1; vertex != end; ++vertex)
+	{
+		std::map<Vertex, unsigned>::iterator found = welded.find(*vertex);
+		if(found == welded.end())
+		{
+			found = welded.insert(std::make_pair(*vertex, vertices->size())).first;
+			vertices->push_back(*vertex);
+		}
+		indices->push_back(found->second);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+number of vertices the post transform cache is taken to hold
+*/
+/****************************************************************************/
+static const unsigned vertexCacheSize = 32;
+//a vertex while the triangles using it are being reordered
+class CacheVertex
+{
+public:
+	float score;
+	//-1 if it is not in the cache
+	int cachePosition;
+	//where its triangles start in the list of triangles of every vertex
+	unsigned firstTriangle;
+	//number of its triangles that are not placed yet, which are kept at the start of its triangles
+	unsigned numOfActiveTriangles;
+};
+/****************************************************************************/
+/*!
+\brief
+Scores how much placing a triangle that uses a vertex now would help. The
+vertices most recently used, and vertices with few triangles left so that
+they can be dropped from the cache for good, score higher
+\param cachePosition
+		position of the vertex in the cache, -1 if it is not in there
+\param numOfActiveTriangles
+		number of triangles using the vertex that are not placed yet
+*/
+/****************************************************************************/
+static float GetVertexScore(const int cachePosition, const unsigned numOfActiveTriangles)
+{
+	if(numOfActiveTriangles == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = 0;
+	if(cachePosition >= 0)
+	{
+		//the 3 vertices of the last triangle score the same so the next one does not favour an edge of it
+		if(cachePosition < 3)
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			score = pow(1.0f - (cachePosition - 3) / static_cast<float>(vertexCacheSize - 3), 1.5f);
+		}
+	}
+	return score + 2.0f / sqrt(static_cast<float>(numOfActiveTriangles));
+}
+/****************************************************************************/
+/*!
+\brief
+Reorders triangles so that the ones sharing vertices are drawn close to
+each other, letting the GPU reuse more of the vertices it already
+transformed. Uses Tom Forsyth's linear speed vertex cache optimisation,
+which greedily places the triangle whose vertices score the highest. The
+vertices are then renumbered in the order they are first used.
+\param vertices
+		the vertices the indices point to
+\param indices
+		3 indices for each triangle
+*/
+/****************************************************************************/
+void MeshBuilder::ReorderForVertexCache(std::vector<Vertex>* vertices, std::vector<unsigned>* indices)
+{
+	const unsigned numOfTriangles = indices->size() / 3;
+	std::vector<CacheVertex> cacheVertices(vertices->size());
+	for(std::vector<CacheVertex>::iterator vertex = cacheVertices.begin(); vertex != cacheVertices.end(); ++vertex)
+	{
+		vertex->cachePosition = -1;
+		vertex->numOfActiveTriangles = 0;
+	}
+	for(unsigned index = 0; index < numOfTriangles * 3; ++index)
+	{
+		++cacheVertices[(*indices)[index]].numOfActiveTriangles;
+	}
+
+	//list the triangles of every vertex one after the other
+	unsigned numOfTriangleUses = 0;
+	for(std::vector<CacheVertex>::iterator vertex = cacheVertices.begin(); vertex != cacheVertices.end(); ++vertex)
+	{
+		vertex->firstTriangle = numOfTriangleUses;
+		numOfTriangleUses += vertex->numOfActiveTriangles;
+		vertex->numOfActiveTriangles = 0;
+		vertex->score = 0;
+	}
+	std::vector<unsigned> vertexTriangles(numOfTriangleUses);
+	for(unsigned index = 0; index < numOfTriangles * 3; ++index)
+	{
+		CacheVertex& vertex = cacheVertices[(*indices)[index]];
+		vertexTriangles[vertex.firstTriangle + vertex.numOfActiveTriangles++] = index / 3;
+	}
+	for(std::vector<CacheVertex>::iterator vertex = cacheVertices.begin(); vertex != cacheVertices.end(); ++vertex)
+	{
+		vertex->score = GetVertexScore(vertex->cachePosition, vertex->numOfActiveTriangles);
+	}
+
+	std::vector<float> triangleScores(numOfTriangles);
+	std::vector<bool> placed(numOfTriangles, false);
+	unsigned bestTriangle = UINT_MAX;
+	for(unsigned triangle = 0; triangle < numOfTriangles; ++triangle)
+	{
+		triangleScores[triangle] = cacheVertices[(*indices)[triangle * 3]].score + cacheVertices[(*indices)[triangle * 3 + 1]].score + cacheVertices[(*indices)[triangle * 3 + 2]].score;
+		if(bestTriangle == UINT_MAX || triangleScores[triangle] > triangleScores[bestTriangle])
+		{
+			bestTriangle = triangle;
+		}
+	}
+
+	std::vector<unsigned> reordered;
+	reordered.reserve(numOfTriangles * 3);
+	//the cache, most recently used first. It holds 3 more vertices while a triangle is being placed
+	std::vector<unsigned> cache, newCache;
+	cache.reserve(vertexCacheSize + 3);
+	newCache.reserve(vertexCacheSize + 3);
+	//where to look for a triangle when none of the ones in the cache are left
+	unsigned nextUnplaced = 0;
+	while(reordered.size() < numOfTriangles * 3)
+	{
+		if(bestTriangle == UINT_MAX)
+		{
+			while(placed[nextUnplaced])
+			{
+				++nextUnplaced;
+			}
+			bestTriangle = nextUnplaced;
+		}
+
+		placed[bestTriangle] = true;
+		newCache.clear();
+		for(unsigned corner = 0; corner < 3; ++corner)
+		{
+			const unsigned index = (*indices)[bestTriangle * 3 + corner];
+			reordered.push_back(index);
+
+			//move the triangle to the end of the vertex's active triangles and stop counting it
+			CacheVertex& vertex = cacheVertices[index];
+			unsigned* triangles = &vertexTriangles[vertex.firstTriangle];
+			for(unsigned active = 0; active < vertex.numOfActiveTriangles; ++active)
+			{
+				if(triangles[active] == bestTriangle)
+				{
+					std::swap(triangles[active], triangles[vertex.numOfActiveTriangles - 1]);
+					--vertex.numOfActiveTriangles;
+					break;
+				}
+			}
+			if(std::find(newCache.begin(), newCache.end(), index) == newCache.end())
+			{
+				newCache.push_back(index);
+			}
+		}
+		const unsigned numOfNewVertices = newCache.size();
+		for(std::vector<unsigned>::const_iterator index = cache.begin(); index != cache.end(); ++index)
+		{
+			if(std::find(newCache.begin(), newCache.begin() + numOfNewVertices, *index) == newCache.begin() + numOfNewVertices)
+			{
+				newCache.push_back(*index);
+			}
+		}
+
+		//vertices pushed past the end of the cache are dropped from it
+		for(unsigned position = 0; position < newCache.size(); ++position)
+		{
+			CacheVertex& vertex = cacheVertices[newCache[position]];
+			vertex.cachePosition = position < vertexCacheSize ? position : -1;
+			vertex.score = GetVertexScore(vertex.cachePosition, vertex.numOfActiveTriangles);
+		}
+
+		//only the triangles of the vertices that were in the cache changed their score
+		bestTriangle = UINT_MAX;
+		for(std::vector<unsigned>::const_iterator index = newCache.begin(); index != newCache.end(); ++index)
+		{
+			const CacheVertex& vertex = cacheVertices[*index];
+			for(unsigned active = 0; active < vertex.numOfActiveTriangles; ++active)
+			{
+				const unsigned triangle = vertexTriangles[vertex.firstTriangle + active];
+				triangleScores[triangle] = cacheVertices[(*indices)[triangle * 3]].score + cacheVertices[(*indices)[triangle * 3 + 1]].score + cacheVertices[(*indices)[triangle * 3 + 2]].score;
+				if(bestTriangle == UINT_MAX || triangleScores[triangle] > triangleScores[bestTriangle])
+				{
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		if(newCache.size() > vertexCacheSize)
+		{
+			newCache.resize(vertexCacheSize);
+		}
+		cache.swap(newCache);
+	}
+
+	//renumber the vertices in the order they are first used so they are read from memory in order too
+	std::vector<unsigned> renumbered(vertices->size(), UINT_MAX);
+	std::vector<Vertex> reorderedVertices;
+	reorderedVertices.reserve(vertices->size());
+	for(std::vector<unsigned>::iterator index = reordered.begin(); index != reordered.end(); ++index)
+	{
+		if(renumbered[*index] == UINT_MAX)
+		{
+			renumbered[*index] = reorderedVertices.size();
+			reorderedVertices.push_back((*vertices)[*index]);
+		}
+		*index = renumbered[*index];
+	}
+
+	vertices->swap(reorderedVertices);
+	indices->swap(reordered);
+}
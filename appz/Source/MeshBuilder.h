@@ -9,6 +9,8 @@ A class that provides methods to generate mesh of different shapes
 */
 /****************************************************************************/
 #include "Mesh.h"
+#include "Voxel.h"
+#include <vector>
 
 /******************************************************************************/
 /*!
@@ -23,4 +25,7 @@ public:
 	static void GenerateQuad(Mesh* mesh, const Color& color, const float& lengthX, const float& lengthY);
 	static void GenerateOBJ(Mesh* mesh, const std::wstring &file_path);
 	static void GenerateText(Mesh* mesh, const unsigned& numRow, const unsigned& numCol);
+	static void GenerateVoxelMesh(Mesh* mesh, const std::vector<Voxel*>& voxels);
+	static void GenerateIndices(const Mesh* mesh, std::vector<Vertex>* vertices, std::vector<unsigned>* indices);
+	static void ReorderForVertexCache(std::vector<Vertex>* vertices, std::vector<unsigned>* indices);
 };
\ No newline at end of file
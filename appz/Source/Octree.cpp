@@ -18,16 +18,19 @@ Default constructor
 		the diameter of our tree
 \param displacement
 		the displacement of our tree in the world
+\param leavesPerChunk
+		number of leaves the tree allocates at a time when it runs out
+\param loose
+		whether the tree is a loose octree
 */
 /****************************************************************************/
-Octree::Octree(int diameter, Vector3 displacement, int subdivisionLimit)
+Octree::Octree(int diameter, Vector3 displacement, unsigned leavesPerChunk, bool loose)
 	:
+arena(leavesPerChunk),
+loose(loose),
 diameter(diameter),
-displacement(displacement),
-subdivisionLimit(subdivisionLimit)
+displacement(displacement)
 {
-	subdivisions = new OctreeLeaf[subdivisionLimit];
-	currentSubdivisionSet = subdivisions;
 	mainLeaf.Set(this);
 	SetRangeTo(diameter, displacement);
 }
@@ -39,19 +42,41 @@ Default destructor
 /****************************************************************************/
 Octree::~Octree()
 {
-	delete [] subdivisions;
 }
-
-
-OctreeLeaf* Octree::GetSubdivisions()
+/****************************************************************************/
+/*!
+\brief
+Returns the arena the leaves and nodes of the tree come from
+*/
+/****************************************************************************/
+OctreeArena& Octree::GetArena()
 {
-	if((currentSubdivisionSet - subdivisions) >= subdivisionLimit)
-	{
-		throw;
-	}
-	OctreeLeaf* current = currentSubdivisionSet;
-	currentSubdivisionSet += 8;
-	return current;
+	return arena;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether the tree is a loose octree
+*/
+/****************************************************************************/
+bool Octree::IsLoose() const
+{
+	return loose;
+}
+/****************************************************************************/
+/*!
+\brief
+Removes every node from the tree. The memory is kept for the next nodes and
+every handle becomes invalid
+*/
+/****************************************************************************/
+void Octree::Clear()
+{
+	slots.clear();
+	freeHandles.clear();
+	//the leaves are reset when they are handed out again so they don't have to be walked here
+	mainLeaf.Set(this, BoundingBox<int>(mainLeaf.GetRangeX(), mainLeaf.GetRangeY(), mainLeaf.GetRangeZ()));
+	arena.Clear();
 }
 
 /****************************************************************************/
@@ -100,39 +125,199 @@ int Octree::GetRadius() const
 Add a voxel to the tree
 \param voxel
 		the voxel to be added
+\return
+		the handle used to move or remove the node
 */
 /****************************************************************************/
-void Octree::AddNode(const BoundingBox<int>& box, const Polygonn& data)
+unsigned Octree::AddNode(const BoundingBox<int>& box, const Polygonn& data)
 {
-	AddNode(OctreeNode(box, data));
+	return AddNode(OctreeNode(box, data));
 }
 
-void Octree::AddNode(const OctreeNode& node)
+unsigned Octree::AddNode(const OctreeNode& node)
 {
-	mainLeaf.AddNode(node);
-}
+	unsigned handle;
+	if(freeHandles.empty())
+	{
+		handle = slots.size();
+		slots.push_back(OctreeSlot());
+	}
+	else
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
 
+	OctreeNode handledNode(node);
+	handledNode.handle = handle;
+	mainLeaf.AddNode(handledNode);
+	return handle;
+}
 /****************************************************************************/
 /*!
 \brief
-Returns the voxel at the specified position
-\param position
-		specifies the position of the voxel
+Removes a node from the tree. Its handle may be given to a node added later
+\param handle
+		the handle of the node
 */
 /****************************************************************************/
-void Octree::GetData(const BoundingBox<int>& box, Polygonn** data_buffer, Polygonn*** data_buffer_end)
+void Octree::RemoveNode(const unsigned handle)
 {
-	GetData(OctreeNode(box), data_buffer, data_buffer_end);
+	OctreeSlot& slot = slots[handle];
+	slot.leaf->RemoveNode(slot.index);
+	slot.leaf = NULL;
+	freeHandles.push_back(handle);
 }
-
-void Octree::GetData(const OctreeNode& node, Polygonn** data_buffer, Polygonn*** data_buffer_end)
+/****************************************************************************/
+/*!
+\brief
+Changes the box of a node. The node stays where it is if its leaf can still
+hold it, otherwise it is put back in from the top of the tree
+\param handle
+		the handle of the node
+\param box
+		the new box of the node
+*/
+/****************************************************************************/
+void Octree::MoveNode(const unsigned handle, const BoundingBox<int>& box)
 {
-	BoundingBox<int> box(mainLeaf.GetRangeX(), mainLeaf.GetRangeY(), mainLeaf.GetRangeZ());
-
-	if(!box.IsOverlapping(node.box))
+	OctreeSlot& slot = slots[handle];
+	if(slot.leaf->CanHold(box))
 	{
+		slot.leaf->GetNode(slot.index).box = box;
 		return;
 	}
 
-	mainLeaf.GetData(node, data_buffer, data_buffer_end);
-}
\ No newline at end of file
+	OctreeNode node(slot.leaf->GetNode(slot.index));
+	node.box = box;
+	slot.leaf->RemoveNode(slot.index);
+	mainLeaf.AddNode(node);
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the node a handle refers to
+\param handle
+		the handle of the node
+*/
+/****************************************************************************/
+OctreeNode& Octree::GetNode(const unsigned handle)
+{
+	const OctreeSlot& slot = slots[handle];
+	return slot.leaf->GetNode(slot.index);
+}
+/****************************************************************************/
+/*!
+\brief
+Called by the leaves to record where the node of a handle is now stored
+\param handle
+		the handle of the node
+\param leaf
+		the leaf the node is in
+\param index
+		index of the node in the leaf
+*/
+/****************************************************************************/
+void Octree::PlaceHandle(const unsigned handle, OctreeLeaf* leaf, const unsigned index)
+{
+	OctreeSlot& slot = slots[handle];
+	slot.leaf = leaf;
+	slot.index = index;
+}
+
+/****************************************************************************/
+/*!
+\brief
+Hands every piece of data whose box overlaps the query to the visitor
+\param query
+		the shape to search with
+\param visitor
+		gets the data found and can stop the search early
+\return
+		false if the visitor stopped the search
+*/
+/****************************************************************************/
+bool Octree::Query(const OctreeQuery& query, OctreeVisitor& visitor)
+{
+	//the top leaf is not culled by its box since the nodes outside of the tree are kept in it
+	return mainLeaf.Query(query, visitor);
+}
+/****************************************************************************/
+/*!
+\brief
+Writes pointers to the data overlapping a box into a buffer
+\param box
+		the box to search with
+\param buffer
+		where the pointers are written to
+\param capacity
+		number of pointers the buffer can hold. The search stops once it is full
+\return
+		number of pointers written
+*/
+/****************************************************************************/
+unsigned Octree::GetData(const BoundingBox<int>& box, Polygonn** buffer, const unsigned capacity)
+{
+	BufferVisitor visitor(buffer, capacity);
+	if(capacity)
+	{
+		Query(BoxQuery(box), visitor);
+	}
+	return visitor.GetSize();
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the k pieces of data closest to a point
+\param point
+		the point to search around
+\param neighbours
+		where the data found and their distances are written to, closest
+		first. Has to fit k neighbours
+\param k
+		the most pieces of data to find
+\param maxDistance
+		how far from the point to search
+\return
+		number of neighbours written
+*/
+/****************************************************************************/
+unsigned Octree::FindNearest(const Vector3& point, OctreeNeighbour* neighbours, const unsigned k, const float maxDistance)
+{
+	OctreeNearestSearch search(mainLeaf, loose, point, maxDistance, k);
+	unsigned numOfNeighbours = 0;
+	while(numOfNeighbours < k && search.Next(&neighbours[numOfNeighbours]))
+	{
+		++numOfNeighbours;
+	}
+	return numOfNeighbours;
+}
+/****************************************************************************/
+/*!
+\brief
+Hands every piece of data within a distance of a point to the visitor,
+closest first. A visitor that only wants the closest few can stop the
+search early and the rest of the tree is never looked at
+\param point
+		the point to search around
+\param radius
+		how far from the point to search
+\param visitor
+		gets the data found and can stop the search early
+\return
+		false if the visitor stopped the search
+*/
+/****************************************************************************/
+bool Octree::FindWithin(const Vector3& point, const float radius, OctreeVisitor& visitor)
+{
+	OctreeNearestSearch search(mainLeaf, loose, point, radius);
+	OctreeNeighbour neighbour;
+	while(search.Next(&neighbour))
+	{
+		if(!visitor.Visit(*neighbour.data))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -9,31 +9,61 @@ An octree made specifically for voxels
 */
 /****************************************************************************/
 #include "OctreeLeaf.h"
+#include "OctreeArena.h"
+#include "OctreeQuery.h"
 #include "Vector3.h"
+#include <vector>
+
+//where the node a handle refers to is currently stored
+class OctreeSlot
+{
+public:
+	OctreeLeaf* leaf;
+	unsigned index;
+};
 /****************************************************************************/
 /*!
 Class VoxelOctree:
 \brief
-An octree made specifically for voxels
+An octree made specifically for voxels. Every node added gets a handle that
+can be used to move or remove it later without searching the tree.
+
+A loose tree places nodes by their centre and lets each leaf hold nodes
+that stick out of it by up to half its size. Nodes then sit as deep as
+their size allows no matter where they are, and a node that moves a little
+usually stays in the same leaf.
 */
 /****************************************************************************/
 class Octree
 {
 public:
-	Octree(int diameter = 0, Vector3 displacement = Vector3(), int subdivisionLimit = 1600);
+	Octree(int diameter = 0, Vector3 displacement = Vector3(), unsigned leavesPerChunk = 1600, bool loose = false);
 	~Octree();
 	void SetRangeTo(int diameter, Vector3 displacement);
-	void AddNode(const BoundingBox<int>& box, const Polygonn& data);
-	void AddNode(const OctreeNode& node);
-	void GetData(const BoundingBox<int>& box, Polygonn** data_buffer, Polygonn*** data_buffer_end);
-	void GetData(const OctreeNode& node, Polygonn** data_buffer, Polygonn*** data_buffer_end);
+	unsigned AddNode(const BoundingBox<int>& box, const Polygonn& data);
+	unsigned AddNode(const OctreeNode& node);
+	void RemoveNode(const unsigned handle);
+	void MoveNode(const unsigned handle, const BoundingBox<int>& box);
+	OctreeNode& GetNode(const unsigned handle);
+	void PlaceHandle(const unsigned handle, OctreeLeaf* leaf, const unsigned index);
+	bool Query(const OctreeQuery& query, OctreeVisitor& visitor);
+	unsigned GetData(const BoundingBox<int>& box, Polygonn** buffer, const unsigned capacity);
+	unsigned FindNearest(const Vector3& point, OctreeNeighbour* neighbours, const unsigned k, const float maxDistance = FLT_MAX);
+	bool FindWithin(const Vector3& point, const float radius, OctreeVisitor& visitor);
 	int GetRadius() const;
-	OctreeLeaf* GetSubdivisions();
-	OctreeLeaf* currentSubdivisionSet;
-	OctreeLeaf* subdivisions;
+	bool IsLoose() const;
+	void Clear();
+	OctreeArena& GetArena();
 private:
+	Octree(const Octree&);
+	Octree& operator=(const Octree&);
+
+	OctreeArena arena;
 	OctreeLeaf mainLeaf;
+	//indexed by handle, handles of removed nodes are reused
+	std::vector<OctreeSlot> slots;
+	std::vector<unsigned> freeHandles;
+	bool loose;
 	int diameter;
-	const int subdivisionLimit;
 	Vector3 displacement;
 };
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "OctreeArena.h"
+#include "OctreeLeaf.h"
+/****************************************************************************/
+/*!
+\file OctreeArena.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that hands out the leaves and nodes of an Octree
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param leavesPerChunk
+		number of leaves allocated at a time. Rounded up to a multiple of 8
+\param nodesPerChunk
+		number of nodes allocated at a time
+*/
+/****************************************************************************/
+OctreeArena::OctreeArena(const unsigned leavesPerChunk, const unsigned nodesPerChunk)
+	:
+currentLeafChunk(0),
+leavesUsed(0),
+leavesPerChunk(leavesPerChunk < 8 ? 8 : (leavesPerChunk + 7) & ~7u),
+currentNodeChunk(0),
+nodesUsed(0),
+nodesPerChunk(nodesPerChunk < minNodeBlockSize ? minNodeBlockSize : nodesPerChunk)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+OctreeArena::~OctreeArena()
+{
+	for(std::vector<OctreeLeaf*>::iterator chunk = leafChunks.begin(); chunk != leafChunks.end(); ++chunk)
+	{
+		delete [] *chunk;
+	}
+	for(std::vector<OctreeNode*>::iterator chunk = nodeChunks.begin(); chunk != nodeChunks.end(); ++chunk)
+	{
+		delete [] *chunk;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a block of 8 leaves for a subdivision
+*/
+/****************************************************************************/
+OctreeLeaf* OctreeArena::AllocateLeaves()
+{
+	if(!freeLeaves.empty())
+	{
+		OctreeLeaf* leaves = freeLeaves.back();
+		freeLeaves.pop_back();
+		return leaves;
+	}
+
+	if(leavesUsed == leavesPerChunk)
+	{
+		++currentLeafChunk;
+		leavesUsed = 0;
+	}
+	if(currentLeafChunk == leafChunks.size())
+	{
+		leafChunks.push_back(new OctreeLeaf[leavesPerChunk]);
+	}
+
+	OctreeLeaf* leaves = leafChunks[currentLeafChunk] + leavesUsed;
+	leavesUsed += 8;
+	return leaves;
+}
+/****************************************************************************/
+/*!
+\brief
+Gives back a block of leaves so the next subdivision can use it
+\param leaves
+		the block returned by AllocateLeaves
+*/
+/****************************************************************************/
+void OctreeArena::FreeLeaves(OctreeLeaf* leaves)
+{
+	freeLeaves.push_back(leaves);
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of nodes a block of the size class holds
+\param sizeClass
+		the size class
+*/
+/****************************************************************************/
+unsigned OctreeArena::GetCapacityOf(const unsigned sizeClass)
+{
+	return minNodeBlockSize << sizeClass;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a contiguous block of nodes
+\param sizeClass
+		the size class of the block. The block holds GetCapacityOf(sizeClass) nodes
+*/
+/****************************************************************************/
+OctreeNode* OctreeArena::AllocateNodes(const unsigned sizeClass)
+{
+	if(sizeClass < freeNodes.size() && !freeNodes[sizeClass].empty())
+	{
+		OctreeNode* nodes = freeNodes[sizeClass].back();
+		freeNodes[sizeClass].pop_back();
+		return nodes;
+	}
+
+	const unsigned capacity = GetCapacityOf(sizeClass);
+	//skip over chunks that don't have enough room left. Their leftovers are only used again after a Clear
+	while(currentNodeChunk < nodeChunks.size() && nodesUsed + capacity > nodeChunkSizes[currentNodeChunk])
+	{
+		++currentNodeChunk;
+		nodesUsed = 0;
+	}
+	if(currentNodeChunk == nodeChunks.size())
+	{
+		//blocks bigger than a chunk get a chunk of their own
+		const unsigned chunkSize = capacity > nodesPerChunk ? capacity : nodesPerChunk;
+		nodeChunks.push_back(new OctreeNode[chunkSize]);
+		nodeChunkSizes.push_back(chunkSize);
+		nodesUsed = 0;
+	}
+
+	OctreeNode* nodes = nodeChunks[currentNodeChunk] + nodesUsed;
+	nodesUsed += capacity;
+	return nodes;
+}
+/****************************************************************************/
+/*!
+\brief
+Gives back a block of nodes so another leaf can use it
+\param nodes
+		the block returned by AllocateNodes
+\param sizeClass
+		the size class the block was allocated with
+*/
+/****************************************************************************/
+void OctreeArena::FreeNodes(OctreeNode* nodes, const unsigned sizeClass)
+{
+	if(sizeClass >= freeNodes.size())
+	{
+		freeNodes.resize(sizeClass + 1);
+	}
+	freeNodes[sizeClass].push_back(nodes);
+}
+/****************************************************************************/
+/*!
+\brief
+Marks every leaf and node as unused without freeing the chunks so the
+tree can be rebuilt without allocating
+*/
+/****************************************************************************/
+void OctreeArena::Clear()
+{
+	currentLeafChunk = 0;
+	leavesUsed = 0;
+	freeLeaves.clear();
+
+	currentNodeChunk = 0;
+	nodesUsed = 0;
+	for(std::vector<std::vector<OctreeNode*> >::iterator freeList = freeNodes.begin(); freeList != freeNodes.end(); ++freeList)
+	{
+		freeList->clear();
+	}
+}
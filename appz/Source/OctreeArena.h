@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include "OctreeNode.h"
+/****************************************************************************/
+/*!
+\file OctreeArena.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that hands out the leaves and nodes of an Octree
+*/
+/****************************************************************************/
+class OctreeLeaf;
+/****************************************************************************/
+/*!
+\brief
+capacity of the smallest block of nodes
+*/
+/****************************************************************************/
+const unsigned minNodeBlockSize = 4;
+/****************************************************************************/
+/*!
+Class OctreeArena:
+\brief
+Hands out the memory of an Octree in large chunks that grow on demand.
+
+Leaves are handed out 8 at a time for a subdivision. The nodes of a leaf
+are kept in one contiguous block whose capacity is a power of 2 times
+minNodeBlockSize (its size class). Freed blocks of leaves and nodes go into
+free lists and are handed out again before any new chunk is allocated.
+Nothing is given back to the system until the arena is destroyed.
+*/
+/****************************************************************************/
+class OctreeArena
+{
+public:
+	OctreeArena(const unsigned leavesPerChunk = 1600, const unsigned nodesPerChunk = 4096);
+	~OctreeArena();
+
+	OctreeLeaf* AllocateLeaves();
+	void FreeLeaves(OctreeLeaf* leaves);
+
+	OctreeNode* AllocateNodes(const unsigned sizeClass);
+	void FreeNodes(OctreeNode* nodes, const unsigned sizeClass);
+	static unsigned GetCapacityOf(const unsigned sizeClass);
+
+	void Clear();
+private:
+	OctreeArena(const OctreeArena&);
+	OctreeArena& operator=(const OctreeArena&);
+
+	std::vector<OctreeLeaf*> leafChunks;
+	//chunk leaves are being carved from and how many of its leaves are used
+	unsigned currentLeafChunk;
+	unsigned leavesUsed;
+	const unsigned leavesPerChunk;
+	std::vector<OctreeLeaf*> freeLeaves;
+
+	std::vector<OctreeNode*> nodeChunks;
+	std::vector<unsigned> nodeChunkSizes;
+	unsigned currentNodeChunk;
+	unsigned nodesUsed;
+	const unsigned nodesPerChunk;
+	//free blocks of every size class
+	std::vector<std::vector<OctreeNode*> > freeNodes;
+};
\ No newline at end of file
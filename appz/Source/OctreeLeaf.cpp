@@ -28,7 +28,12 @@ Default constructor
 OctreeLeaf::OctreeLeaf(const BoundingBox<int>& box)
 	:
 box(box),
-leaves(NULL)
+leaves(NULL),
+parent(NULL),
+tree(NULL),
+nodes(NULL),
+numOfNodes(0),
+nodeSizeClass(0)
 {
 }
 /****************************************************************************/
@@ -55,6 +60,12 @@ void OctreeLeaf::Set(Octree* tree, const BoundingBox<int>& box)
 		this->tree = tree;
 	}
 	SetBoundingBoxTo(box);
+	//leaves are reused by the arena so whatever the last owner left behind is forgotten
+	leaves = NULL;
+	parent = NULL;
+	nodes = NULL;
+	numOfNodes = 0;
+	nodeSizeClass = 0;
 }
 /****************************************************************************/
 /*!
@@ -73,11 +84,11 @@ Add a voxel to the leaf
 /****************************************************************************/
 void OctreeLeaf::AddNode(const OctreeNode& node)
 {
-	unsigned index = GetIndex(node);
+	unsigned index = tree->IsLoose() ? GetLooseIndex(node) : GetIndex(node);
 	//if index overlaps more than one node
 	if(index == 8)
 	{
-		nodes.push_back(node);
+		PushNode(node);
 	}
 	else if(HasAlreadySubdivided())
 	{
@@ -91,7 +102,142 @@ void OctreeLeaf::AddNode(const OctreeNode& node)
 	}
 	else
 	{
-		nodes.push_back(node);
+		PushNode(node);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Stores a node in this leaf, moving the nodes to a bigger block when the
+current one is full
+\param node
+		the node to store
+*/
+/****************************************************************************/
+void OctreeLeaf::PushNode(const OctreeNode& node)
+{
+	OctreeArena& arena = tree->GetArena();
+	if(!nodes)
+	{
+		nodeSizeClass = 0;
+		nodes = arena.AllocateNodes(nodeSizeClass);
+	}
+	else if(numOfNodes == OctreeArena::GetCapacityOf(nodeSizeClass))
+	{
+		OctreeNode* biggerNodes = arena.AllocateNodes(nodeSizeClass + 1);
+		for(unsigned index = 0; index < numOfNodes; ++index)
+		{
+			biggerNodes[index] = nodes[index];
+		}
+		arena.FreeNodes(nodes, nodeSizeClass);
+		nodes = biggerNodes;
+		++nodeSizeClass;
+	}
+	nodes[numOfNodes] = node;
+	tree->PlaceHandle(node.handle, this, numOfNodes);
+	++numOfNodes;
+}
+/****************************************************************************/
+/*!
+\brief
+Removes a node from the leaf by moving the last node into its place. A
+subdivision that is left with nothing in it goes back to the arena
+\param index
+		index of the node in the leaf
+*/
+/****************************************************************************/
+void OctreeLeaf::RemoveNode(const unsigned index)
+{
+	--numOfNodes;
+	if(index != numOfNodes)
+	{
+		nodes[index] = nodes[numOfNodes];
+		tree->PlaceHandle(nodes[index].handle, this, index);
+	}
+	if(!numOfNodes)
+	{
+		tree->GetArena().FreeNodes(nodes, nodeSizeClass);
+		nodes = NULL;
+		//this leaf may be freed along with its siblings so nothing can be done after this
+		if(parent && !HasAlreadySubdivided())
+		{
+			parent->Collapse();
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a node stored in the leaf
+\param index
+		index of the node in the leaf
+*/
+/****************************************************************************/
+OctreeNode& OctreeLeaf::GetNode(const unsigned index)
+{
+	return nodes[index];
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of nodes stored in the leaf itself
+*/
+/****************************************************************************/
+unsigned OctreeLeaf::GetNumOfNodes() const
+{
+	return numOfNodes;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a leaf the leaf was subdivided into
+\param index
+		index of the leaf, from 0 to 7
+*/
+/****************************************************************************/
+OctreeLeaf& OctreeLeaf::GetLeaf(const unsigned index)
+{
+	return leaves[index];
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether a node with this box can stay in the leaf
+\param box
+		the box of the node
+*/
+/****************************************************************************/
+bool OctreeLeaf::CanHold(const BoundingBox<int>& box) const
+{
+	//a loose leaf only has to keep its nodes inside its loose box for queries to find them
+	const BoundingBox<int> bounds = tree->IsLoose() ? GetLooseBox() : this->box;
+	return box.rangeX.start >= bounds.rangeX.start && box.rangeX.end <= bounds.rangeX.end &&
+		box.rangeY.start >= bounds.rangeY.start && box.rangeY.end <= bounds.rangeY.end &&
+		box.rangeZ.start >= bounds.rangeZ.start && box.rangeZ.end <= bounds.rangeZ.end;
+}
+/****************************************************************************/
+/*!
+\brief
+Gives the subdivisions of the leaf back to the arena once all of them are
+empty, then does the same for the leaf above it if that left it empty too.
+The leaf may be freed by the time this returns
+*/
+/****************************************************************************/
+void OctreeLeaf::Collapse()
+{
+	for(unsigned index = 0; index < 8; ++index)
+	{
+		if(!leaves[index].IsEmpty())
+		{
+			return;
+		}
+	}
+	tree->GetArena().FreeLeaves(leaves);
+	leaves = NULL;
+
+	if(parent && !numOfNodes)
+	{
+		parent->Collapse();
 	}
 }
 /****************************************************************************/
@@ -125,6 +271,25 @@ const Range<int>& OctreeLeaf::GetRangeZ() const
 	return box.rangeZ;
 }
 
+/****************************************************************************/
+/*!
+\brief
+Returns the box of the leaf grown by half its size on every side. In a
+loose tree, the nodes of the leaf and its subdivisions are all inside it
+*/
+/****************************************************************************/
+BoundingBox<int> OctreeLeaf::GetLooseBox() const
+{
+	//rounded up since the nodes' midpoints are rounded down
+	const int halfX = (box.rangeX.Length() + 1) / 2;
+	const int halfY = (box.rangeY.Length() + 1) / 2;
+	const int halfZ = (box.rangeZ.Length() + 1) / 2;
+	return BoundingBox<int>(
+		Range<int>(box.rangeX.start - halfX, box.rangeX.end + halfX),
+		Range<int>(box.rangeY.start - halfY, box.rangeY.end + halfY),
+		Range<int>(box.rangeZ.start - halfZ, box.rangeZ.end + halfZ));
+}
+
 Range<int> OctreeLeaf::GetLowerRangeX() const
 {
 	int midpointX = box.rangeX.MidPoint();
@@ -209,53 +374,40 @@ BoundingBox<int> OctreeLeaf::GetBox8() const
 	return BoundingBox<int>(GetUpperRangeX(), GetUpperRangeY(), GetUpperRangeZ());
 }
 
-void OctreeLeaf::GetData(const OctreeNode& testNode, Polygonn** data_buffer, Polygonn*** data_buffer_end)
+/****************************************************************************/
+/*!
+\brief
+Hands the data in this leaf and its subdivisions that overlaps the query to
+the visitor. Subdivisions the query doesn't overlap are skipped entirely.
+\param query
+		the shape to search with
+\param visitor
+		gets the data found and can stop the search early
+\return
+		false if the visitor stopped the search
+*/
+/****************************************************************************/
+bool OctreeLeaf::Query(const OctreeQuery& query, OctreeVisitor& visitor)
 {
-	unsigned char collisionCheck = CheckCollisionWithBoxes(testNode);
-
-	for(std::vector<OctreeNode>::iterator node = nodes.begin(), end = nodes.end(); node != end; ++node)
+	for(OctreeNode* node = nodes, *end = nodes + numOfNodes; node != end; ++node)
 	{
-		if(node->box.IsOverlapping(testNode.box))
+		if(query.IsOverlapping(node->box) && !visitor.Visit(node->data))
 		{
-			*data_buffer = &node->data;
-			*data_buffer_end = ++data_buffer;
+			return false;
 		}
 	}
 	if(HasAlreadySubdivided())
 	{
-		if(collisionCheck & 0x01)
-		{
-			leaves[1].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x02)
-		{
-			leaves[2].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x04)
-		{
-			leaves[3].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x08)
-		{
-			leaves[4].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x10)
-		{
-			leaves[5].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x20)
-		{
-			leaves[6].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x40)
+		for(unsigned index = 0; index < 8; ++index)
 		{
-			leaves[7].GetData(testNode, data_buffer, data_buffer_end);
-		}
-		if(collisionCheck & 0x80)
-		{
-			leaves[8].GetData(testNode, data_buffer, data_buffer_end);
+			OctreeLeaf& leaf = leaves[index];
+			if(!leaf.IsEmpty() && query.IsOverlapping(tree->IsLoose() ? leaf.GetLooseBox() : leaf.box) && !leaf.Query(query, visitor))
+			{
+				return false;
+			}
 		}
 	}
+	return true;
 }
 /****************************************************************************/
 /*!
@@ -269,7 +421,7 @@ void OctreeLeaf::Subdivide()
 		lowerRangeY = GetLowerRangeY(), upperRangeY = GetUpperRangeY(),
 		lowerRangeZ = GetLowerRangeZ(), upperRangeZ = GetUpperRangeZ();
 
-	leaves = tree->GetSubdivisions();
+	leaves = tree->GetArena().AllocateLeaves();
 	OctreeLeaf* leaf = leaves;
 
 	leaf->Set(tree, GetBox1());
@@ -288,6 +440,11 @@ void OctreeLeaf::Subdivide()
 	++leaf;
 	leaf->Set(tree, GetBox8());
 	++leaf;
+
+	for(leaf = leaves; leaf != leaves + 8; ++leaf)
+	{
+		leaf->parent = this;
+	}
 }
 /****************************************************************************/
 /*!
@@ -307,57 +464,19 @@ Returns a bool to whether or not the leaf is empty
 /****************************************************************************/
 bool OctreeLeaf::IsEmpty() const
 {
-	return nodes.empty() && !HasAlreadySubdivided();
+	return !numOfNodes && !HasAlreadySubdivided();
 }
 /****************************************************************************/
 /*!
 \brief
-Turns a position into an index
-\param position
-		the position used to get an index
+Picks the subdivision a node goes into
+\param node
+		the node to be placed
+\return
+		the index of the subdivision, or 8 if the node overlaps more than one
+		of them or is not inside of this leaf
 */
 /****************************************************************************/
-
-
-unsigned char OctreeLeaf::CheckCollisionWithBoxes(const OctreeNode& testNode) const
-{
-	unsigned char returnValue = 0;
-	
-	if(testNode.box.IsOverlapping(GetBox1()))
-	{
-		returnValue = returnValue | 0x01;
-	}
-	if(testNode.box.IsOverlapping(GetBox2()))
-	{
-		returnValue = returnValue | 0x02;
-	}
-	if(testNode.box.IsOverlapping(GetBox3()))
-	{
-		returnValue = returnValue | 0x04;
-	}
-	if(testNode.box.IsOverlapping(GetBox4()))
-	{
-		returnValue = returnValue | 0x08;
-	}
-	if(testNode.box.IsOverlapping(GetBox5()))
-	{
-		returnValue = returnValue | 0x10;
-	}
-	if(testNode.box.IsOverlapping(GetBox6()))
-	{
-		returnValue = returnValue | 0x20;
-	}
-	if(testNode.box.IsOverlapping(GetBox7()))
-	{
-		returnValue = returnValue | 0x40;
-	}
-	if(testNode.box.IsOverlapping(GetBox8()))
-	{
-		returnValue = returnValue | 0x80;
-	}
-	return returnValue;
-}
-
 unsigned OctreeLeaf::GetIndex(const OctreeNode& node) const
 {
 	unsigned x,y,z;
@@ -366,6 +485,14 @@ unsigned OctreeLeaf::GetIndex(const OctreeNode& node) const
 		testRangeY = node.box.rangeY,
 		testRangeZ = node.box.rangeZ;
 
+	//a node that sticks out of the top of the tree stays there, where queries always look at it
+	if(!box.rangeX.IsInRange(testRangeX.start) || !box.rangeX.IsInRange(testRangeX.end) ||
+		!box.rangeY.IsInRange(testRangeY.start) || !box.rangeY.IsInRange(testRangeY.end) ||
+		!box.rangeZ.IsInRange(testRangeZ.start) || !box.rangeZ.IsInRange(testRangeZ.end))
+	{
+		return 8;
+	}
+
 	Range<int> lowerRangeX = GetLowerRangeX(), upperRangeX = GetUpperRangeX(),
 		lowerRangeY = GetLowerRangeY(), upperRangeY = GetUpperRangeY(),
 		lowerRangeZ = GetLowerRangeZ(), upperRangeZ = GetUpperRangeZ();
@@ -378,13 +505,9 @@ unsigned OctreeLeaf::GetIndex(const OctreeNode& node) const
 	{
 		x = 0;
 	}
-	else if(upperRangeX.IsInRange(testRangeX))
-	{
-		x = 1;
-	}
 	else
 	{
-		throw;
+		x = 1;
 	}
 	
 	if(lowerRangeY.IsInRange(testRangeY) && upperRangeY.IsInRange(testRangeY))
@@ -395,13 +518,9 @@ unsigned OctreeLeaf::GetIndex(const OctreeNode& node) const
 	{
 		y = 0;
 	}
-	else if(upperRangeY.IsInRange(testRangeY))
-	{
-		y = 1;
-	}
 	else
 	{
-		throw;
+		y = 1;
 	}
 	
 	if(lowerRangeZ.IsInRange(testRangeZ) && upperRangeZ.IsInRange(testRangeZ))
@@ -412,15 +531,45 @@ unsigned OctreeLeaf::GetIndex(const OctreeNode& node) const
 	{
 		z = 0;
 	}
-	else if(upperRangeZ.IsInRange(testRangeZ))
+	else
 	{
 		z = 1;
 	}
-	else
+
+	return x*4 + y*2 + z;
+}
+/****************************************************************************/
+/*!
+\brief
+Picks the subdivision of a loose tree a node goes into by its centre
+\param node
+		the node to be placed
+\return
+		the index of the subdivision, or 8 if the node is too big for it or
+		its centre is outside of this leaf
+*/
+/****************************************************************************/
+unsigned OctreeLeaf::GetLooseIndex(const OctreeNode& node) const
+{
+	const int centreX = node.box.rangeX.MidPoint();
+	const int centreY = node.box.rangeY.MidPoint();
+	const int centreZ = node.box.rangeZ.MidPoint();
+	if(!box.rangeX.IsInRange(centreX) || !box.rangeY.IsInRange(centreY) || !box.rangeZ.IsInRange(centreZ))
 	{
-		throw;
+		return 8;
 	}
 
+	const unsigned x = centreX > box.rangeX.MidPoint();
+	const unsigned y = centreY > box.rangeY.MidPoint();
+	const unsigned z = centreZ > box.rangeZ.MidPoint();
+	const Range<int> rangeX = x ? GetUpperRangeX() : GetLowerRangeX();
+	const Range<int> rangeY = y ? GetUpperRangeY() : GetLowerRangeY();
+	const Range<int> rangeZ = z ? GetUpperRangeZ() : GetLowerRangeZ();
+	//the subdivision's loose box only reaches half its size past its own box
+	if(node.box.rangeX.Length() > rangeX.Length() || node.box.rangeY.Length() > rangeY.Length() || node.box.rangeZ.Length() > rangeZ.Length())
+	{
+		return 8;
+	}
 	return x*4 + y*2 + z;
 }
 /****************************************************************************/
@@ -11,6 +11,7 @@ A node in the voxelOctree
 #include <iostream>
 #include <vector>
 #include "OctreeNode.h"
+#include "OctreeQuery.h"
 /****************************************************************************/
 /*!
 \brief
@@ -52,8 +53,14 @@ public:
 	BoundingBox<int> GetBox6() const;
 	BoundingBox<int> GetBox7() const;
 	BoundingBox<int> GetBox8() const;
+	BoundingBox<int> GetLooseBox() const;
 	void AddNode(const OctreeNode& node);
-	void GetData(const OctreeNode& testNode, Polygonn** data_buffer, Polygonn*** data_buffer_end);
+	void RemoveNode(const unsigned index);
+	OctreeNode& GetNode(const unsigned index);
+	unsigned GetNumOfNodes() const;
+	OctreeLeaf& GetLeaf(const unsigned index);
+	bool CanHold(const BoundingBox<int>& box) const;
+	bool Query(const OctreeQuery& query, OctreeVisitor& visitor);
 	void Subdivide();
 	bool HasAlreadySubdivided() const;
 	bool IsEmpty() const;
@@ -61,11 +68,18 @@ public:
 	
 private:
 	unsigned GetIndex(const OctreeNode& node) const;
-	unsigned char CheckCollisionWithBoxes(const OctreeNode& testNode) const;
+	unsigned GetLooseIndex(const OctreeNode& node) const;
+	void PushNode(const OctreeNode& node);
+	void Collapse();
 	
 	BoundingBox<int> box;
 
 	OctreeLeaf* leaves;
+	//the leaf this one is a subdivision of, NULL for the top of the tree
+	OctreeLeaf* parent;
 	Octree* tree;
-	std::vector<OctreeNode> nodes;
+	//block of nodes from the tree's arena
+	OctreeNode* nodes;
+	unsigned numOfNodes;
+	unsigned nodeSizeClass;
 };
\ No newline at end of file
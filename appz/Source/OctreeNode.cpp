@@ -11,7 +11,8 @@ A class used to store and handle OctreeNode information
 OctreeNode::OctreeNode(const BoundingBox<int>& box, const Polygonn& data)
 	:
 box(box),
-data(data)
+data(data),
+handle(0)
 {
 }
 
@@ -27,4 +27,6 @@ public:
 
 	BoundingBox<int> box;
 	Polygonn data;
+	//handle the tree gave the node when it was added
+	unsigned handle;
 };
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "OctreeQuery.h"
+#include "OctreeLeaf.h"
+#include <algorithm>
+#include <cmath>
+/****************************************************************************/
+/*!
+\file OctreeQuery.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Classes used to search an Octree
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Returns the squared distance from a point to the closest point of a box
+\param point
+		the point
+\param box
+		the box
+*/
+/****************************************************************************/
+static float GetDistanceSquared(const Vector3& point, const BoundingBox<int>& box)
+{
+	float distanceSquared = 0;
+	const float position[3] = {point.x, point.y, point.z};
+	const Range<int>* ranges[3] = {&box.rangeX, &box.rangeY, &box.rangeZ};
+	for(unsigned axis = 0; axis < 3; ++axis)
+	{
+		float distance = 0;
+		if(position[axis] < ranges[axis]->start)
+		{
+			distance = ranges[axis]->start - position[axis];
+		}
+		else if(position[axis] > ranges[axis]->end)
+		{
+			distance = position[axis] - ranges[axis]->end;
+		}
+		distanceSquared += distance * distance;
+	}
+	return distanceSquared;
+}
+/****************************************************************************/
+/*!
+\brief
+Orders candidates so that the heap functions keep the closest one on top
+*/
+/****************************************************************************/
+static bool IsFurther(const OctreeCandidate& first, const OctreeCandidate& second)
+{
+	return first.distanceSquared > second.distanceSquared;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+OctreeQuery::~OctreeQuery()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param box
+		the box to search with
+*/
+/****************************************************************************/
+BoxQuery::BoxQuery(const BoundingBox<int>& box)
+	:
+box(box)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+BoxQuery::~BoxQuery()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+returns whether the query box overlaps a box of the tree
+\param box
+		the box of a leaf or node
+*/
+/****************************************************************************/
+bool BoxQuery::IsOverlapping(const BoundingBox<int>& box) const
+{
+	return this->box.IsOverlapping(box);
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param centre
+		the centre of the sphere
+\param radius
+		the radius of the sphere
+*/
+/****************************************************************************/
+SphereQuery::SphereQuery(const Vector3& centre, const float radius)
+	:
+centre(centre),
+radius(radius)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+SphereQuery::~SphereQuery()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+returns whether the sphere overlaps a box of the tree
+\param box
+		the box of a leaf or node
+*/
+/****************************************************************************/
+bool SphereQuery::IsOverlapping(const BoundingBox<int>& box) const
+{
+	return GetDistanceSquared(centre, box) <= radius * radius;
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param frustum
+		the frustum of the camera
+*/
+/****************************************************************************/
+FrustumQuery::FrustumQuery(const Frustum& frustum)
+	:
+frustum(frustum)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+FrustumQuery::~FrustumQuery()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+returns whether a box of the tree is at least partly inside the frustum
+\param box
+		the box of a leaf or node
+*/
+/****************************************************************************/
+bool FrustumQuery::IsOverlapping(const BoundingBox<int>& box) const
+{
+	return frustum.IsOverlapping(Vector3(box.rangeX.start, box.rangeY.start, box.rangeZ.start), Vector3(box.rangeX.end, box.rangeY.end, box.rangeZ.end));
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+OctreeVisitor::~OctreeVisitor()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param buffer
+		where the pointers are written to
+\param capacity
+		number of pointers the buffer can hold
+*/
+/****************************************************************************/
+BufferVisitor::BufferVisitor(Polygonn** buffer, const unsigned capacity)
+	:
+buffer(buffer),
+capacity(capacity),
+size(0)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+BufferVisitor::~BufferVisitor()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Adds the data to the buffer
+\param data
+		the data found
+\return
+		false once the buffer is full
+*/
+/****************************************************************************/
+bool BufferVisitor::Visit(Polygonn& data)
+{
+	if(size == capacity)
+	{
+		return false;
+	}
+	buffer[size++] = &data;
+	return size != capacity;
+}
+/****************************************************************************/
+/*!
+\brief
+number of pointers written to the buffer
+*/
+/****************************************************************************/
+unsigned BufferVisitor::GetSize() const
+{
+	return size;
+}
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param root
+		the leaf the search starts from
+\param loose
+		whether the leaves are loose, in which case their loose boxes are used
+\param point
+		the point to search around
+\param maxDistance
+		how far from the point to search
+\param maxResults
+		the most results the search hands out
+*/
+/****************************************************************************/
+OctreeNearestSearch::OctreeNearestSearch(OctreeLeaf& root, const bool loose, const Vector3& point, const float maxDistance, const unsigned maxResults)
+	:
+point(point),
+loose(loose),
+maxDistanceSquared(maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX),
+maxResults(maxResults),
+numOfResults(0)
+{
+	//the root holds the nodes outside of the tree so it is always searched, whatever its box is
+	if(!root.IsEmpty())
+	{
+		Push(0, &root, NULL);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+OctreeNearestSearch::~OctreeNearestSearch()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the next closest piece of data
+\param neighbour
+		where the data and its distance are written to
+\return
+		false once there is nothing left within range or enough results were
+		handed out
+*/
+/****************************************************************************/
+bool OctreeNearestSearch::Next(OctreeNeighbour* neighbour)
+{
+	while(!candidates.empty() && numOfResults < maxResults)
+	{
+		std::pop_heap(candidates.begin(), candidates.end(), IsFurther);
+		const OctreeCandidate candidate = candidates.back();
+		candidates.pop_back();
+
+		//nothing left in the queue is closer than this node
+		if(candidate.node)
+		{
+			++numOfResults;
+			neighbour->data = &candidate.node->data;
+			neighbour->distance = sqrt(candidate.distanceSquared);
+			return true;
+		}
+
+		OctreeLeaf& leaf = *candidate.leaf;
+		for(unsigned index = 0; index < leaf.GetNumOfNodes(); ++index)
+		{
+			OctreeNode& node = leaf.GetNode(index);
+			Push(GetDistanceSquared(point, node.box), NULL, &node);
+		}
+		if(leaf.HasAlreadySubdivided())
+		{
+			for(unsigned index = 0; index < 8; ++index)
+			{
+				OctreeLeaf& child = leaf.GetLeaf(index);
+				if(child.IsEmpty())
+				{
+					continue;
+				}
+				const BoundingBox<int> box = loose ? child.GetLooseBox() : BoundingBox<int>(child.GetRangeX(), child.GetRangeY(), child.GetRangeZ());
+				Push(GetDistanceSquared(point, box), &child, NULL);
+			}
+		}
+	}
+	return false;
+}
+/****************************************************************************/
+/*!
+\brief
+Queues a leaf or a node unless it is out of range or further than enough
+nodes that were already queued
+\param distanceSquared
+		squared distance from the point to the box of the leaf or node
+\param leaf
+		the leaf, or NULL if a node is queued
+\param node
+		the node, or NULL if a leaf is queued
+*/
+/****************************************************************************/
+void OctreeNearestSearch::Push(const float distanceSquared, OctreeLeaf* leaf, OctreeNode* node)
+{
+	//the closest nodes include the ones already handed out since they are still closer than anything left
+	if(distanceSquared > maxDistanceSquared || (!closest.empty() && closest.size() >= maxResults && distanceSquared > closest.front()))
+	{
+		return;
+	}
+	//an unlimited search can never prune so the bounded queue is not kept
+	if(node && maxResults != UINT_MAX)
+	{
+		if(closest.size() < maxResults)
+		{
+			closest.push_back(distanceSquared);
+			std::push_heap(closest.begin(), closest.end());
+		}
+		else if(distanceSquared < closest.front())
+		{
+			std::pop_heap(closest.begin(), closest.end());
+			closest.back() = distanceSquared;
+			std::push_heap(closest.begin(), closest.end());
+		}
+	}
+
+	OctreeCandidate candidate;
+	candidate.distanceSquared = distanceSquared;
+	candidate.leaf = leaf;
+	candidate.node = node;
+	candidates.push_back(candidate);
+	std::push_heap(candidates.begin(), candidates.end(), IsFurther);
+}
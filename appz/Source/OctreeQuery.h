@@ -0,0 +1,192 @@
+#pragma once
+#include "BoundingBox.h"
+#include "Polygon.h"
+#include "Frustum.h"
+#include <vector>
+#include <climits>
+#include <cfloat>
+/****************************************************************************/
+/*!
+\file OctreeQuery.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Classes used to search an Octree
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class OctreeQuery:
+\brief
+Interface for the shape an Octree is searched with. Every leaf and node
+whose box the shape overlaps is visited.
+*/
+/****************************************************************************/
+class OctreeQuery
+{
+public:
+	virtual ~OctreeQuery();
+	/****************************************************************************/
+	/*!
+	\brief
+	returns whether the shape overlaps a box of the tree
+	\param box
+	the box of a leaf or node
+	*/
+	/****************************************************************************/
+	virtual bool IsOverlapping(const BoundingBox<int>& box) const = 0;
+};
+/****************************************************************************/
+/*!
+Class BoxQuery:
+\brief
+Searches the tree with an axis aligned box
+*/
+/****************************************************************************/
+class BoxQuery : public OctreeQuery
+{
+public:
+	BoxQuery(const BoundingBox<int>& box);
+	virtual ~BoxQuery();
+	virtual bool IsOverlapping(const BoundingBox<int>& box) const;
+private:
+	BoundingBox<int> box;
+};
+/****************************************************************************/
+/*!
+Class SphereQuery:
+\brief
+Searches the tree with a sphere
+*/
+/****************************************************************************/
+class SphereQuery : public OctreeQuery
+{
+public:
+	SphereQuery(const Vector3& centre, const float radius);
+	virtual ~SphereQuery();
+	virtual bool IsOverlapping(const BoundingBox<int>& box) const;
+private:
+	Vector3 centre;
+	float radius;
+};
+/****************************************************************************/
+/*!
+Class FrustumQuery:
+\brief
+Searches the tree for everything a camera can see
+*/
+/****************************************************************************/
+class FrustumQuery : public OctreeQuery
+{
+public:
+	FrustumQuery(const Frustum& frustum);
+	virtual ~FrustumQuery();
+	virtual bool IsOverlapping(const BoundingBox<int>& box) const;
+private:
+	Frustum frustum;
+};
+/****************************************************************************/
+/*!
+Class OctreeVisitor:
+\brief
+Interface for whatever wants the data found by a search. The data is
+handed over where it is stored in the tree so nothing gets copied.
+*/
+/****************************************************************************/
+class OctreeVisitor
+{
+public:
+	virtual ~OctreeVisitor();
+	/****************************************************************************/
+	/*!
+	\brief
+	called for every piece of data the search finds
+	\param data
+	the data found
+	\return
+	false to stop the search
+	*/
+	/****************************************************************************/
+	virtual bool Visit(Polygonn& data) = 0;
+};
+/****************************************************************************/
+/*!
+Class BufferVisitor:
+\brief
+Collects pointers to the data found into a buffer until the buffer is full
+*/
+/****************************************************************************/
+class BufferVisitor : public OctreeVisitor
+{
+public:
+	BufferVisitor(Polygonn** buffer, const unsigned capacity);
+	virtual ~BufferVisitor();
+	virtual bool Visit(Polygonn& data);
+	unsigned GetSize() const;
+private:
+	Polygonn** buffer;
+	unsigned capacity;
+	unsigned size;
+};
+/****************************************************************************/
+/*!
+Class OctreeNeighbour:
+\brief
+A piece of data found near a point and how far its box is from the point
+*/
+/****************************************************************************/
+class OctreeNeighbour
+{
+public:
+	Polygonn* data;
+	float distance;
+};
+
+class OctreeLeaf;
+class OctreeNode;
+
+//a leaf or a node waiting to be looked at by an OctreeNearestSearch
+class OctreeCandidate
+{
+public:
+	float distanceSquared;
+	//NULL when the candidate is a node
+	OctreeLeaf* leaf;
+	OctreeNode* node;
+};
+/****************************************************************************/
+/*!
+Class OctreeNearestSearch:
+\brief
+Finds the data of an Octree closest to a point, one at a time and nearest
+first. Distances are measured to the closest point of each box. Leaves and
+nodes wait in a priority queue ordered by distance, so a leaf is only
+opened once everything closer has been handed out and the search can stop
+at any time without looking at the rest of the tree.
+
+When the number of results is limited, the distances of the closest nodes
+queued so far are kept in a queue bounded to that number. Anything further
+than the furthest of them can never be a result and is never queued. The
+tree must not change while a search is running.
+*/
+/****************************************************************************/
+class OctreeNearestSearch
+{
+public:
+	OctreeNearestSearch(OctreeLeaf& root, const bool loose, const Vector3& point, const float maxDistance = FLT_MAX, const unsigned maxResults = UINT_MAX);
+	~OctreeNearestSearch();
+	bool Next(OctreeNeighbour* neighbour);
+private:
+	void Push(const float distanceSquared, OctreeLeaf* leaf, OctreeNode* node);
+
+	Vector3 point;
+	bool loose;
+	float maxDistanceSquared;
+	unsigned maxResults;
+	unsigned numOfResults;
+	//a min heap of everything waiting to be looked at
+	std::vector<OctreeCandidate> candidates;
+	//a max heap of the closest maxResults node distances queued so far
+	std::vector<float> closest;
+};
@@ -0,0 +1,243 @@
+#include "PhysicsWorld.h"
+#include <cfloat>
+/****************************************************************************/
+/*!
+\file PhysicsWorld.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that steps the simulation of a range of bodies
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+PhysicsWorld::PhysicsWorld()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+PhysicsWorld::~PhysicsWorld()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Fills the tree of a body with the polygons of its mesh
+\param body
+		the body whose tree is built
+\param matrix
+		the transform the polygons are moved by
+\return
+		the box around the moved polygons
+*/
+/****************************************************************************/
+AABBBox PhysicsWorld::BuildTree(CollisionBody* body, const Mtx44& matrix)
+{
+	AABBBox box(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
+	Mesh* mesh = body->mesh;
+	if(!mesh)
+	{
+		return box;
+	}
+
+	const Polygonn* polies = mesh->GetBegin();
+	const unsigned size = mesh->GetSize();
+	body->tree.IncreaseCapacityTo(size);
+
+	AABBTreeNode* node = body->tree.GetBegin();
+	AABBTreeNode* nodeEnd = body->tree.GetEnd();
+
+	const Polygonn* begin = polies;
+	const Polygonn* end = begin + size;
+	for(Polygonn const* it = begin; it != end && node != nodeEnd; ++it, ++node)
+	{
+		node->data = *it;
+		node->data.MoveBy(matrix);
+		node->box = node->data.GetBoundingBox();
+
+		box.ResizeToFit(node->box);
+	}
+	body->tree.Sort(box, end - begin);
+	return box;
+}
+/****************************************************************************/
+/*!
+\brief
+Builds the trees of all bodies where they currently are and measures how
+small their features are so fast bodies know how finely to step
+\param begin
+		first body
+\param end
+		one past the last body
+*/
+/****************************************************************************/
+void PhysicsWorld::BuildTrees(CollisionBody*const begin, CollisionBody*const end)
+{
+	for(CollisionBody* body = begin; body != end; ++body)
+	{
+		const AABBBox box = BuildTree(body, body->GetMatrix());
+		float smallest = box.rangeX.Length();
+		if(box.rangeY.Length() < smallest)
+		{
+			smallest = box.rangeY.Length();
+		}
+		if(box.rangeZ.Length() < smallest)
+		{
+			smallest = box.rangeZ.Length();
+		}
+		body->SetFeatureSizeTo(smallest);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Moves a fast body through the step in substeps, colliding it against the
+trees the other bodies have for this step after every substep
+\param body
+		the substepping body
+\param deltaTime
+		time passed over the whole step
+\param begin
+		first body
+\param end
+		one past the last body
+*/
+/****************************************************************************/
+void PhysicsWorld::Substep(CollisionBody* body, const double deltaTime, CollisionBody*const begin, CollisionBody*const end)
+{
+	const unsigned numOfSubsteps = body->GetNumOfSubsteps();
+	const double substepTime = deltaTime / numOfSubsteps;
+	for(unsigned substep = 0; substep < numOfSubsteps; ++substep)
+	{
+		body->TempUpdateTo(substepTime);
+		Mtx44 mtx1 = body->GetMatrix();
+		body->TempUpdateTo(-substepTime);
+
+		BuildTree(body, mtx1);
+
+		const unsigned numOfCollisions = body->GetNumOfCollisions();
+		collisionSystem.UpdateSubstep(body, begin, end);
+		//slow down for every body hit during this substep only
+		body->Decelerate(substepTime * (body->GetNumOfCollisions() - numOfCollisions));
+		body->TempUpdateTo(substepTime);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Steps the simulation
+\param deltaTime
+		time passed
+\param begin
+		first body
+\param end
+		one past the last body
+*/
+/****************************************************************************/
+void PhysicsWorld::UpdateTo(const double deltaTime, CollisionBody*const begin, CollisionBody*const end)
+{
+	//Update the velocity of all bodies before doing collision
+	//sleeping bodies are left out of the store and keep their old trees since they are not moving
+	bodyStore.Gather(begin, end);
+	bodyStore.IntegrateVelocities(deltaTime);
+	bodyStore.CapVelocities();
+	bodyStore.ScatterVelocities();
+
+	CollisionBody*const* awakeBodies = bodyStore.GetBodies();
+	const unsigned numOfAwakeBodies = bodyStore.GetSize();
+	for(unsigned index = 0; index < numOfAwakeBodies; ++index)
+	{
+		CollisionBody* body = awakeBodies[index];
+
+		body->UpdateSubstepsTo(deltaTime);
+		if(body->velocity.IsZero() || !body->mesh)
+		{
+			continue;
+		}
+
+		//the tree is built where the body will be at the end of the step.
+		//substepping bodies need it too since pairs of them are still collided in the main pass, and Substep rebuilds it after
+		body->TempUpdateTo(deltaTime);
+		Mtx44 mtx1 = body->GetMatrix();
+		body->TempUpdateTo(-deltaTime);
+
+		BuildTree(body, mtx1);
+	}
+
+	collisionSystem.UpdateTo(deltaTime, begin, end);
+
+	//fast bodies move themselves in substeps. They go before the rest are moved so that the others still see their hits
+	for(unsigned index = 0; index < numOfAwakeBodies; ++index)
+	{
+		if(awakeBodies[index]->IsSubstepping())
+		{
+			Substep(awakeBodies[index], deltaTime, begin, end);
+		}
+	}
+
+	//move the bodies. Bodies woken up by a collision this step have no velocity yet so they can wait for the next step
+	bodyStore.GatherTransforms();
+	bodyStore.Decelerate(deltaTime);
+	bodyStore.IntegratePositions(deltaTime);
+	bodyStore.ScatterTransforms();
+	for(unsigned index = 0; index < numOfAwakeBodies; ++index)
+	{
+		awakeBodies[index]->UpdateForcesTo(deltaTime);
+	}
+
+	collisionSystem.UpdateSleeping(deltaTime, begin, end);
+
+	//let everything react to the collisions now that the bodies are done moving
+	collisionSystem.GetEvents().Dispatch();
+}
+/****************************************************************************/
+/*!
+\brief
+number of bodies that were awake during the last step
+*/
+/****************************************************************************/
+unsigned PhysicsWorld::GetNumOfAwakeBodies() const
+{
+	return bodyStore.GetSize();
+}
+/****************************************************************************/
+/*!
+\brief
+number of overlapping polygon boxes found during the last step
+*/
+/****************************************************************************/
+unsigned PhysicsWorld::GetNumOfContacts() const
+{
+	return collisionSystem.GetNumOfContacts();
+}
+/****************************************************************************/
+/*!
+\brief
+number of intersecting polygons found during the last step
+*/
+/****************************************************************************/
+unsigned PhysicsWorld::GetNumOfHits() const
+{
+	return collisionSystem.GetNumOfHits();
+}
+
+/****************************************************************************/
+/*!
+\brief
+the queue the collisions of every step go through. Add listeners to it to
+hear about collisions
+*/
+/****************************************************************************/
+CollisionEventQueue& PhysicsWorld::GetCollisionEvents()
+{
+	return collisionSystem.GetEvents();
+}
\ No newline at end of file
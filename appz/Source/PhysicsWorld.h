@@ -0,0 +1,43 @@
+#pragma once
+#include "CollisionBody.h"
+#include "CollisionSystem.h"
+#include "BodyStore.h"
+/****************************************************************************/
+/*!
+\file PhysicsWorld.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class that steps the simulation of a range of bodies
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class PhysicsWorld:
+\brief
+Steps the simulation of a range of bodies: integrates their velocities,
+rebuilds the trees of the moving ones, resolves their collisions and moves
+them. Bodies that would move further than their own size in a step are
+split into substeps and collided against the rest of the world on their own. It has no knowledge of rendering so it can be run without a window.
+*/
+/****************************************************************************/
+class PhysicsWorld
+{
+public:
+	PhysicsWorld();
+	~PhysicsWorld();
+	void BuildTrees(CollisionBody*const begin, CollisionBody*const end);
+	void UpdateTo(const double deltaTime, CollisionBody*const begin, CollisionBody*const end);
+
+	unsigned GetNumOfAwakeBodies() const;
+	unsigned GetNumOfContacts() const;
+	unsigned GetNumOfHits() const;
+	CollisionEventQueue& GetCollisionEvents();
+private:
+	AABBBox BuildTree(CollisionBody* body, const Mtx44& matrix);
+	void Substep(CollisionBody* body, const double deltaTime, CollisionBody*const begin, CollisionBody*const end);
+
+	BodyStore bodyStore;
+	CollisionSystem collisionSystem;
+};
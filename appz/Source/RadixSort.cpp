@@ -0,0 +1,68 @@
+#include "RadixSort.h"
+#include <algorithm>
+/****************************************************************************/
+/*!
+\file RadixSort.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Sorts 64 bit keys along with what they belong to
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Sorts keys along with the index of what each key belongs to. The sort is a
+least significant digit radix sort so equal keys keep the order they were
+in, and digits that are the same for every key are skipped
+\param keys
+		the keys to sort
+\param indices
+		the index of what each key belongs to
+\param bits
+		number of low bits of the keys that are in use
+*/
+/****************************************************************************/
+void RadixSort(std::vector<unsigned long long>& keys, std::vector<unsigned>& indices, const unsigned bits)
+{
+	const unsigned digitBits = 11;
+	const unsigned numOfBuckets = 1 << digitBits;
+	if(keys.empty())
+	{
+		return;
+	}
+	std::vector<unsigned long long> sortedKeys(keys.size());
+	std::vector<unsigned> sortedIndices(indices.size());
+	std::vector<unsigned> offsets(numOfBuckets);
+
+	for(unsigned shift = 0; shift < bits; shift += digitBits)
+	{
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for(std::vector<unsigned long long>::const_iterator key = keys.begin(); key != keys.end(); ++key)
+		{
+			++offsets[(*key >> shift) & (numOfBuckets - 1)];
+		}
+		//the digit is the same for every key so this pass would not move anything
+		if(offsets[(keys.front() >> shift) & (numOfBuckets - 1)] == keys.size())
+		{
+			continue;
+		}
+
+		unsigned total = 0;
+		for(unsigned bucket = 0; bucket < numOfBuckets; ++bucket)
+		{
+			const unsigned count = offsets[bucket];
+			offsets[bucket] = total;
+			total += count;
+		}
+		for(unsigned index = 0; index < keys.size(); ++index)
+		{
+			const unsigned destination = offsets[(keys[index] >> shift) & (numOfBuckets - 1)]++;
+			sortedKeys[destination] = keys[index];
+			sortedIndices[destination] = indices[index];
+		}
+		keys.swap(sortedKeys);
+		indices.swap(sortedIndices);
+	}
+}
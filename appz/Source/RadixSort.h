@@ -0,0 +1,13 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file RadixSort.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Sorts 64 bit keys along with what they belong to
+*/
+/****************************************************************************/
+#include <vector>
+
+void RadixSort(std::vector<unsigned long long>& keys, std::vector<unsigned>& indices, const unsigned bits = 64);
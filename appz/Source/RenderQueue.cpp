@@ -0,0 +1,128 @@
+#include "RenderQueue.h"
+#include "RadixSort.h"
+#include <cstring>
+/****************************************************************************/
+/*!
+\file RenderQueue.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Collects what is drawn in a frame so it can be drawn in the cheapest order
+*/
+/****************************************************************************/
+
+//bits of the sort key each part starts at
+const unsigned renderKeyLitShift = 60;
+const unsigned renderKeyTextureShift = 44;
+const unsigned renderKeyMeshShift = 28;
+const unsigned renderKeyDepthBits = 28;
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+RenderQueue::RenderQueue()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+RenderQueue::~RenderQueue()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Empties the queue for the next frame. The memory is kept so a queue used
+every frame stops allocating once it has grown to fit a frame
+*/
+/****************************************************************************/
+void RenderQueue::Clear()
+{
+	packets.clear();
+	keys.clear();
+	order.clear();
+}
+/****************************************************************************/
+/*!
+\brief
+Adds a packet to the queue
+\param packet
+		the packet to draw
+\param depth
+		distance of the packet in front of the camera
+*/
+/****************************************************************************/
+void RenderQueue::Add(const RenderPacket& packet, const float depth)
+{
+	keys.push_back(MakeKey(packet.draw->enableLight, packet.textureID, packet.meshID, depth));
+	order.push_back(packets.size());
+	packets.push_back(packet);
+}
+/****************************************************************************/
+/*!
+\brief
+Sorts the packets by their keys. Packets with the same key stay in the
+order they were added in
+*/
+/****************************************************************************/
+void RenderQueue::Sort()
+{
+	RadixSort(keys, order);
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of packets in the queue
+*/
+/****************************************************************************/
+unsigned RenderQueue::GetSize() const
+{
+	return packets.size();
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a packet in the order they are drawn in
+\param index
+		position of the packet in the queue
+*/
+/****************************************************************************/
+const RenderPacket& RenderQueue::GetPacket(const unsigned index) const
+{
+	return packets[order[index]];
+}
+/****************************************************************************/
+/*!
+\brief
+Makes the sort key of a packet. The texture and mesh get 16 bits each
+\param lit
+		whether the packet is drawn with lighting
+\param textureID
+		ID of the texture, 0 if it has none
+\param meshID
+		ID of the mesh
+\param depth
+		distance in front of the camera. Anything behind the camera is
+		treated as being right at it
+*/
+/****************************************************************************/
+unsigned long long RenderQueue::MakeKey(const bool lit, const unsigned textureID, const unsigned meshID, const float depth)
+{
+	//the bits of a positive float sort the same way as its value so the top bits are a depth that keeps its precision up close
+	unsigned depthBits = 0;
+	if(depth > 0)
+	{
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+		depthBits >>= 31 - renderKeyDepthBits;
+	}
+	return static_cast<unsigned long long>(lit) << renderKeyLitShift |
+		static_cast<unsigned long long>(textureID & 0xFFFF) << renderKeyTextureShift |
+		static_cast<unsigned long long>(meshID & 0xFFFF) << renderKeyMeshShift |
+		depthBits;
+}
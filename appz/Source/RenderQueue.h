@@ -0,0 +1,55 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file RenderQueue.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Collects what is drawn in a frame so it can be drawn in the cheapest order
+*/
+/****************************************************************************/
+#include <vector>
+#include "DrawOrder.h"
+/****************************************************************************/
+/*!
+Class RenderPacket:
+\brief
+Everything needed to draw 1 DrawOrder, worked out when it is queued
+*/
+/****************************************************************************/
+class RenderPacket
+{
+public:
+	const DrawOrder* draw;
+	Mtx44 model;
+	unsigned meshID;
+	unsigned textureID;
+};
+/****************************************************************************/
+/*!
+Class RenderQueue:
+\brief
+The packets drawn in a frame, each with a 64 bit sort key. From the highest
+bits down the key holds the shader state, the texture, the mesh and the
+depth, so sorting the keys puts packets that share state next to each other
+and draws the packets of the same state front to back. The keys are sorted
+with a radix sort, which skips the bits that every key shares.
+*/
+/****************************************************************************/
+class RenderQueue
+{
+public:
+	RenderQueue();
+	~RenderQueue();
+	void Clear();
+	void Add(const RenderPacket& packet, const float depth);
+	void Sort();
+	unsigned GetSize() const;
+	const RenderPacket& GetPacket(const unsigned index) const;
+	static unsigned long long MakeKey(const bool lit, const unsigned textureID, const unsigned meshID, const float depth);
+private:
+	std::vector<RenderPacket> packets;
+	std::vector<unsigned long long> keys;
+	//packets in the order they are drawn in once sorted
+	std::vector<unsigned> order;
+};
@@ -29,7 +29,7 @@ SceneMain::SceneMain(Keyboard* keyboard, FirstPersonMouse* mouse, Sound& snd, Gr
 Scene(snd, gfx),
 keyboard(keyboard),
 mouse(mouse),
-collisionSystem(),
+physics(),
 screenBuffer(NULL),
 globals(&gfx)
 {
@@ -443,39 +443,16 @@ void SceneMain::InnitCollisions()
 	
 	unsigned numOfPolys = 0;
 
-	//Update the velocity of all draws before doing collision
 	CollisionBody*const begin = globals.GetBodies();
 	CollisionBody*const end = globals.GetLastBody();
 	for(CollisionBody* body = begin; body != end; ++body)
 	{
-		Mesh* mesh = body->mesh;
-		if(mesh)
+		if(body->mesh)
 		{
-			const Polygonn* polies = mesh->GetBegin();
-			const unsigned size = mesh->GetSize();
-			numOfPolys += size;
-
-			body->tree.IncreaseCapacityTo(size);
-
-			Mtx44 mtx1 = body->GetMatrix();
-
-			AABBTreeNode* node = body->tree.GetBegin();
-			AABBTreeNode* nodeEnd = body->tree.GetEnd();
-			
-			AABBBox box(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
-			const Polygonn* begin = polies;
-			const Polygonn* end = begin + size;
-			for(Polygonn const* it = begin; it != end && node != nodeEnd; ++it, ++node)
-			{
-				node->data = *it;
-				node->data.MoveBy(mtx1);
-				node->box = node->data.GetBoundingBox();
-
-				box.ResizeToFit(node->box);
-			}
-			body->tree.Sort(box, end - begin);
+			numOfPolys += body->mesh->GetSize();
 		}
 	}
+	physics.BuildTrees(begin, end);
 	world.IncreaseCapacityTo(numOfPolys);
 }
 
@@ -487,13 +464,13 @@ initializing forces, acceleration.
 /****************************************************************************/
 void SceneMain::InnitForces()
 {
-	Vector3 accelerationDueToGravity(0, -9.8f, 0);
+	gravity.SetAccelerationTo(Vector3(0, -9.8f, 0));
 
 	CollisionBody*const begin = globals.GetBodies();
 	CollisionBody*const end = globals.GetLastBody();
 	for(CollisionBody* body = begin; body != end; ++body)
 	{
-		body->AddForce(accelerationDueToGravity * body->mass);
+		body->AddForceGenerator(&gravity);
 	}
 }
 /****************************************************************************/
@@ -582,56 +559,12 @@ void SceneMain::UpdateDraws(const double& deltaTime)
 	CollisionBody* currentPlayer = globals.GetCollisionBody(L"player");
 	Rotation rotate = camera.GetRotation() - currentPlayer->draw->transform.rotate;
 	currentPlayer->rotationVelocity.Set(rotate.yaw, 0, 0);
-
-	//Update the velocity of all draws before doing collision
-	CollisionBody*const begin = globals.GetBodies();
-	CollisionBody*const end = globals.GetLastBody();
-	for(CollisionBody* body = begin; body != end; ++body)
+	if(!currentPlayer->rotationVelocity.IsZero())
 	{
-		body->UpdateVelocity(deltaTime);
-
-		if(body->velocity.IsZero())
-		{
-			continue;
-		}
-
-		Mesh* mesh = body->mesh;
-
-		if(mesh)
-		{
-			const Polygonn* polies = mesh->GetBegin();
-			const unsigned size = mesh->GetSize();
-			body->tree.IncreaseCapacityTo(size);
-
-			body->TempUpdateTo(deltaTime);
-			Mtx44 mtx1 = body->GetMatrix();
-			body->TempUpdateTo(-deltaTime);
-
-			AABBTreeNode* node = body->tree.GetBegin();
-			AABBTreeNode* nodeEnd = body->tree.GetEnd();
-
-			AABBBox box(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
-			const Polygonn* begin = polies;
-			const Polygonn* end = begin + size;
-			for(Polygonn const* it = begin; it != end && node != nodeEnd; ++it, ++node)
-			{
-				node->data = *it;
-				node->data.MoveBy(mtx1);
-				node->box = node->data.GetBoundingBox();
-
-				box.ResizeToFit(node->box);
-			}
-			body->tree.Sort(box, end - begin);
-		}
+		currentPlayer->WakeUp();
 	}
 
-	collisionSystem.UpdateTo(deltaTime, begin, end);
-
-	//update the draws
-	for(CollisionBody* body = begin; body != end; ++body)
-	{
-		body->UpdateTo(deltaTime);
-	}
+	physics.UpdateTo(deltaTime, globals.GetBodies(), globals.GetLastBody());
 }
 /****************************************************************************/
 /*!
@@ -643,6 +576,8 @@ void SceneMain::Render()
 {
 	gfx.BeginDrawing();
 
+	//only the DrawOrders that moved or had their meshes changed work out their bounds again
+	globals.GetDraw(L"main")->UpdateBounds();
 	gfx.RenderDraw(globals.GetDraw(L"main"));
 
 	//gfx.RenderUI(currentUI);
@@ -14,7 +14,8 @@ Class SceneMain that updates and init, main scene to be rendered
 #include "MatrixStack.h"
 #include "GlobalList.h"
 #include "UI.h"
-#include "CollisionSystem.h"
+#include "PhysicsWorld.h"
+#include "GravityForce.h"
 #include "FirstPersonMouse.h"
 #include "Keyboard.h"
 /****************************************************************************/
@@ -45,7 +46,8 @@ private:
 
 	//physics
 	AABBTree world;
-	CollisionSystem collisionSystem;
+	PhysicsWorld physics;
+	GravityForce gravity;
 
 	//rendering
 	int screenX;
@@ -0,0 +1,302 @@
+#include "VoxelChunkFile.h"
+#include <Windows.h>
+/****************************************************************************/
+/*!
+\file VoxelChunkFile.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A file that stores a world of voxels in chunks
+*/
+/****************************************************************************/
+
+//"VXCF" at the start of every chunk file
+const unsigned voxelChunkFileID = 0x46435856;
+const unsigned voxelChunkFileVersion = 1;
+//views of a file have to start at a multiple of this
+const unsigned voxelChunkFileAlignment = 65536;
+//number of slots the file grows by when it runs out
+const unsigned voxelChunkFileGrowth = 64;
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+*/
+/****************************************************************************/
+VoxelChunkFile::VoxelChunkFile()
+	:
+file(NULL),
+mapping(NULL),
+header(NULL),
+slots(NULL),
+headerSize(0),
+capacity(0)
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+VoxelChunkFile::~VoxelChunkFile()
+{
+	Close();
+}
+/****************************************************************************/
+/*!
+\brief
+Opens a chunk file, making it if it does not exist yet
+\param path
+		path of the file
+\param chunksX, chunksY, chunksZ
+		number of chunks the world has along each axis. They have to match
+		the file if it already exists
+\return
+		false if the file could not be opened or is for a different world
+*/
+/****************************************************************************/
+bool VoxelChunkFile::Open(const char* path, const int chunksX, const int chunksY, const int chunksZ)
+{
+	Close();
+	if(chunksX <= 0 || chunksY <= 0 || chunksZ <= 0)
+	{
+		return false;
+	}
+
+	HANDLE fileHandle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	file = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		Close();
+		return false;
+	}
+
+	const unsigned numOfChunks = chunksX * chunksY * chunksZ;
+	headerSize = sizeof(VoxelChunkFileHeader) + numOfChunks * sizeof(unsigned);
+	headerSize = (headerSize + voxelChunkFileAlignment - 1) / voxelChunkFileAlignment * voxelChunkFileAlignment;
+
+	const bool isNew = fileSize.QuadPart == 0;
+	if(!isNew && fileSize.QuadPart < headerSize)
+	{
+		Close();
+		return false;
+	}
+	if(!Remap(isNew ? 0 : static_cast<unsigned>((fileSize.QuadPart - headerSize) / voxelChunkBytes)))
+	{
+		Close();
+		return false;
+	}
+
+	header = static_cast<VoxelChunkFileHeader*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, headerSize));
+	if(!header)
+	{
+		Close();
+		return false;
+	}
+	slots = reinterpret_cast<unsigned*>(header + 1);
+
+	if(isNew)
+	{
+		//the file is filled with zeros when it grows so every slot starts out empty
+		header->id = voxelChunkFileID;
+		header->version = voxelChunkFileVersion;
+		header->numOfChunks[0] = chunksX;
+		header->numOfChunks[1] = chunksY;
+		header->numOfChunks[2] = chunksZ;
+		header->numOfSlots = 0;
+	}
+	else if(header->id != voxelChunkFileID || header->version != voxelChunkFileVersion ||
+		header->numOfChunks[0] != chunksX || header->numOfChunks[1] != chunksY || header->numOfChunks[2] != chunksZ ||
+		header->numOfSlots > capacity)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the header back and closes the file. Views of chunks that are still
+mapped stay usable until they are unmapped
+*/
+/****************************************************************************/
+void VoxelChunkFile::Close()
+{
+	if(header)
+	{
+		FlushViewOfFile(header, headerSize);
+		UnmapViewOfFile(header);
+		header = NULL;
+		slots = NULL;
+	}
+	if(mapping)
+	{
+		CloseHandle(mapping);
+		mapping = NULL;
+	}
+	if(file)
+	{
+		CloseHandle(file);
+		file = NULL;
+	}
+	capacity = 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether the file is open
+*/
+/****************************************************************************/
+bool VoxelChunkFile::IsOpen() const
+{
+	return header != NULL;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of chunks the world has along an axis
+\param axis
+		0 for x, 1 for y and 2 for z
+*/
+/****************************************************************************/
+int VoxelChunkFile::GetNumOfChunks(const unsigned axis) const
+{
+	return header ? header->numOfChunks[axis] : 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether a chunk has been stored in the file
+\param chunk
+		index of the chunk, x + y * chunksX + z * chunksX * chunksY
+*/
+/****************************************************************************/
+bool VoxelChunkFile::HasChunk(const unsigned chunk) const
+{
+	return slots[chunk] != 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Maps a view of a chunk's cells
+\param chunk
+		index of the chunk
+\param create
+		whether to give the chunk a slot if it has not been stored yet
+\return
+		the cells of the chunk, or NULL if it is not stored and create is
+		false or if the file could not grow
+*/
+/****************************************************************************/
+VoxelCell* VoxelChunkFile::MapChunk(const unsigned chunk, const bool create)
+{
+	unsigned slot = slots[chunk];
+	if(!slot)
+	{
+		if(!create)
+		{
+			return NULL;
+		}
+		if(header->numOfSlots == capacity && !Remap(capacity + voxelChunkFileGrowth))
+		{
+			return NULL;
+		}
+		slot = ++header->numOfSlots;
+		slots[chunk] = slot;
+	}
+
+	const unsigned long long offset = headerSize + static_cast<unsigned long long>(slot - 1) * voxelChunkBytes;
+	return static_cast<VoxelCell*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), voxelChunkBytes));
+}
+/****************************************************************************/
+/*!
+\brief
+Writes the header to the disk
+*/
+/****************************************************************************/
+void VoxelChunkFile::Flush()
+{
+	if(header)
+	{
+		FlushViewOfFile(header, headerSize);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Unmaps a view of a chunk. Safe to call from any thread
+\param cells
+		the view returned by MapChunk
+\param write
+		whether the chunk was changed and has to be written to the disk now
+		instead of whenever the OS gets to it
+*/
+/****************************************************************************/
+void VoxelChunkFile::UnmapChunk(VoxelCell* cells, const bool write)
+{
+	if(write)
+	{
+		FlushViewOfFile(cells, voxelChunkBytes);
+	}
+	UnmapViewOfFile(cells);
+}
+/****************************************************************************/
+/*!
+\brief
+Reads a view of a chunk into memory by touching every page of it, so that
+whoever uses the chunk next does not wait on the disk. Mapping a view only
+reserves the addresses, the pages are read on their first access. Safe to
+call from any thread
+\param cells
+		the view returned by MapChunk
+*/
+/****************************************************************************/
+void VoxelChunkFile::PrefetchChunk(const VoxelCell* cells)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	const unsigned pageSize = info.dwPageSize;
+
+	//volatile so the reads are not optimised away
+	const volatile unsigned char* bytes = reinterpret_cast<const volatile unsigned char*>(cells);
+	for(unsigned offset = 0; offset < voxelChunkBytes; offset += pageSize)
+	{
+		bytes[offset];
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Maps the file again so that it can hold more slots. Views made from the
+old mapping stay valid after it is closed
+\param capacity
+		number of slots the mapping should cover
+\return
+		false if the file could not be mapped
+*/
+/****************************************************************************/
+bool VoxelChunkFile::Remap(const unsigned capacity)
+{
+	const unsigned long long size = headerSize + static_cast<unsigned long long>(capacity) * voxelChunkBytes;
+	HANDLE newMapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), NULL);
+	if(!newMapping)
+	{
+		return false;
+	}
+	if(mapping)
+	{
+		CloseHandle(mapping);
+	}
+	mapping = newMapping;
+	this->capacity = capacity;
+	return true;
+}
@@ -0,0 +1,108 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file VoxelChunkFile.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A file that stores a world of voxels in chunks
+*/
+/****************************************************************************/
+#include "Voxel.h"
+/****************************************************************************/
+/*!
+\brief
+number of voxels along each side of a chunk
+*/
+/****************************************************************************/
+const int voxelChunkSize = 32;
+/****************************************************************************/
+/*!
+\brief
+number of voxels in a chunk
+*/
+/****************************************************************************/
+const unsigned voxelsPerChunk = voxelChunkSize * voxelChunkSize * voxelChunkSize;
+/****************************************************************************/
+/*!
+Class VoxelCell:
+\brief
+A voxel as it is stored in a chunk. The position comes from where the cell
+is in the chunk so only the color and solidness are kept. A solidness of 0
+means there is no voxel.
+*/
+/****************************************************************************/
+class VoxelCell
+{
+public:
+	unsigned char red;
+	unsigned char green;
+	unsigned char blue;
+	unsigned char solidness;
+};
+/****************************************************************************/
+/*!
+\brief
+number of bytes a chunk takes in the file. It is a multiple of the 64KB
+that views of a file have to be aligned to
+*/
+/****************************************************************************/
+const unsigned voxelChunkBytes = voxelsPerChunk * sizeof(VoxelCell);
+/****************************************************************************/
+/*!
+Class VoxelChunkFileHeader:
+\brief
+The start of a chunk file. It is followed by the slot of every chunk in the
+world, 0 for chunks that were never stored
+*/
+/****************************************************************************/
+class VoxelChunkFileHeader
+{
+public:
+	unsigned id;
+	unsigned version;
+	int numOfChunks[3];
+	unsigned numOfSlots;
+};
+/****************************************************************************/
+/*!
+Class VoxelChunkFile:
+\brief
+A memory mapped file of voxel chunks. The world is a fixed grid of chunks
+but only the chunks that were written to take up space in the file, each in
+its own slot after the header. A chunk is used by mapping a view of its
+slot, so reading it in is left to the OS.
+
+The cells of a chunk are ordered by x, then z, then y so that every column
+of voxels is contiguous.
+*/
+/****************************************************************************/
+class VoxelChunkFile
+{
+public:
+	VoxelChunkFile();
+	~VoxelChunkFile();
+	bool Open(const char* path, const int chunksX, const int chunksY, const int chunksZ);
+	void Close();
+	bool IsOpen() const;
+	int GetNumOfChunks(const unsigned axis) const;
+	bool HasChunk(const unsigned chunk) const;
+	VoxelCell* MapChunk(const unsigned chunk, const bool create);
+	void Flush();
+	static void UnmapChunk(VoxelCell* cells, const bool write);
+	static void PrefetchChunk(const VoxelCell* cells);
+private:
+	VoxelChunkFile(const VoxelChunkFile&);
+	VoxelChunkFile& operator=(const VoxelChunkFile&);
+
+	bool Remap(const unsigned capacity);
+
+	//HANDLEs kept as void* so that windows.h stays out of this header
+	void* file;
+	void* mapping;
+	VoxelChunkFileHeader* header;
+	unsigned* slots;
+	unsigned headerSize;
+	//number of slots the current mapping covers
+	unsigned capacity;
+};
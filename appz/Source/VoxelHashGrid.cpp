@@ -0,0 +1,389 @@
+#include "VoxelHashGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+/****************************************************************************/
+/*!
+\file VoxelHashGrid.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A hash table of voxels keyed on their position
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+key of the empty slots. No position packs into it since the top bit is never used
+*/
+/****************************************************************************/
+const unsigned long long emptyKey = ~0ull;
+/****************************************************************************/
+/*!
+\brief
+the lowest and highest position a key can hold on every axis
+*/
+/****************************************************************************/
+const int lowestKeyPosition = -(1 << 20);
+const int highestKeyPosition = (1 << 20) - 1;
+/****************************************************************************/
+/*!
+\brief
+Default constructor
+\param expectedNumOfVoxels
+		number of voxels the table is made big enough for at the start
+*/
+/****************************************************************************/
+VoxelHashGrid::VoxelHashGrid(const unsigned expectedNumOfVoxels)
+	:
+bounds(Range<int>(INT_MAX, INT_MIN), Range<int>(INT_MAX, INT_MIN), Range<int>(INT_MAX, INT_MIN)),
+dirty(false)
+{
+	//the table is kept at most half full
+	unsigned numOfSlots = 16;
+	while(numOfSlots < expectedNumOfVoxels * 2)
+	{
+		numOfSlots *= 2;
+	}
+	keys.assign(numOfSlots, emptyKey);
+	indices.resize(numOfSlots);
+	voxelData.reserve(expectedNumOfVoxels);
+}
+
+VoxelHashGrid::VoxelHashGrid(VoxelHashGrid& grid)
+	:
+keys(grid.keys),
+indices(grid.indices),
+voxelData(grid.voxelData),
+bounds(grid.bounds),
+dirty(true)
+{
+}
+
+void VoxelHashGrid::operator=(VoxelHashGrid& grid)
+{
+	keys = grid.keys;
+	indices = grid.indices;
+	voxelData = grid.voxelData;
+	voxels.clear();
+	bounds = grid.bounds;
+	dirty = true;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+VoxelHashGrid::~VoxelHashGrid()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Packs a position into a key
+\param position
+		the position in the world
+\return
+		the key, or emptyKey if the position is outside of what a key holds
+*/
+/****************************************************************************/
+unsigned long long VoxelHashGrid::GetKey(const Vector3& position)
+{
+	//checked before converting since the axes are cut down to 21 bits, which would fold the position onto another one
+	if(!(position.x > lowestKeyPosition - 1 && position.x < highestKeyPosition + 1) ||
+		!(position.y > lowestKeyPosition - 1 && position.y < highestKeyPosition + 1) ||
+		!(position.z > lowestKeyPosition - 1 && position.z < highestKeyPosition + 1))
+	{
+		return emptyKey;
+	}
+
+	//offset the axes so negative positions pack too
+	const unsigned long long x = (static_cast<int>(position.x) + (1 << 20)) & 0x1FFFFF;
+	const unsigned long long y = (static_cast<int>(position.y) + (1 << 20)) & 0x1FFFFF;
+	const unsigned long long z = (static_cast<int>(position.z) + (1 << 20)) & 0x1FFFFF;
+	return x << 42 | y << 21 | z;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the slot that holds the key or the empty slot it would go into
+\param key
+		the key to look for
+*/
+/****************************************************************************/
+unsigned VoxelHashGrid::FindSlot(const unsigned long long key) const
+{
+	//mixes the bits of the key so that neighbouring positions are spread out over the table
+	unsigned long long hash = key;
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+
+	const unsigned mask = keys.size() - 1;
+	unsigned slot = static_cast<unsigned>(hash) & mask;
+	while(keys[slot] != key && keys[slot] != emptyKey)
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+/****************************************************************************/
+/*!
+\brief
+Moves every key into a new table
+\param newNumOfSlots
+		size of the new table. Must be a power of 2
+*/
+/****************************************************************************/
+void VoxelHashGrid::Rehash(const unsigned newNumOfSlots)
+{
+	std::vector<unsigned long long> oldKeys(newNumOfSlots, emptyKey);
+	std::vector<unsigned> oldIndices(newNumOfSlots);
+	oldKeys.swap(keys);
+	oldIndices.swap(indices);
+
+	for(unsigned slot = 0; slot < oldKeys.size(); ++slot)
+	{
+		if(oldKeys[slot] != emptyKey)
+		{
+			const unsigned newSlot = FindSlot(oldKeys[slot]);
+			keys[newSlot] = oldKeys[slot];
+			indices[newSlot] = oldIndices[slot];
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Add a voxel to the grid. If there is already a voxel at its position, the
+first one added is kept. Voxels outside of the positions a key holds are
+left out
+\param voxel
+		the voxel to be added
+*/
+/****************************************************************************/
+void VoxelHashGrid::AddVoxel(const Voxel& voxel)
+{
+	if(!voxel.GetSolidness())
+	{
+		return;
+	}
+	const unsigned long long key = GetKey(voxel.GetPosition());
+	if(key == emptyKey)
+	{
+		return;
+	}
+	if((voxelData.size() + 1) * 2 > keys.size())
+	{
+		Rehash(keys.size() * 2);
+	}
+
+	const unsigned slot = FindSlot(key);
+	if(keys[slot] == key)
+	{
+		return;
+	}
+	keys[slot] = key;
+	indices[slot] = voxelData.size();
+	voxelData.push_back(voxel);
+	dirty = true;
+
+	//the same cell the key was made from
+	const Vector3& position = voxel.GetPosition();
+	const int x = static_cast<int>(position.x);
+	const int y = static_cast<int>(position.y);
+	const int z = static_cast<int>(position.z);
+	bounds.ResizeToFit(BoundingBox<int>(Range<int>(x, x), Range<int>(y, y), Range<int>(z, z)));
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the voxel at the specified position
+\param position
+		specifies the position of the voxel
+*/
+/****************************************************************************/
+Voxel* VoxelHashGrid::GetVoxel(const Vector3& position)
+{
+	const unsigned long long key = GetKey(position);
+	if(key == emptyKey)
+	{
+		return NULL;
+	}
+	const unsigned slot = FindSlot(key);
+	if(keys[slot] != key)
+	{
+		return NULL;
+	}
+	return &voxelData[indices[slot]];
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the first voxel a ray hits by stepping through every cell the ray
+passes, one cell at a time. The ray is clipped to the cells the voxels are
+in first, so however far it reaches, only the cells in there are stepped
+through. There is no empty space to skip inside of them so every cell
+costs a lookup
+\param ray
+		the ray to cast
+\param hit
+		where the voxel hit is written to
+\return
+		whether a voxel was hit
+*/
+/****************************************************************************/
+bool VoxelHashGrid::Raycast(const VoxelRay& ray, VoxelRayHit* hit)
+{
+	hit->voxel = NULL;
+	const float length = ray.direction.Length();
+	if(voxelData.empty() || length == 0)
+	{
+		return false;
+	}
+
+	//the cell of every voxel starts half a unit before its position
+	const float direction[3] = {ray.direction.x / length, ray.direction.y / length, ray.direction.z / length};
+	const float origin[3] = {ray.origin.x + 0.5f, ray.origin.y + 0.5f, ray.origin.z + 0.5f};
+	const int lowest[3] = {bounds.rangeX.start, bounds.rangeY.start, bounds.rangeZ.start};
+	const int highest[3] = {bounds.rangeX.end, bounds.rangeY.end, bounds.rangeZ.end};
+
+	//clip the ray to the cells the voxels are in
+	float distance = 0;
+	float furthest = ray.maxDistance;
+	int entryAxis = -1;
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		if(direction[axis] == 0)
+		{
+			if(origin[axis] < lowest[axis] || origin[axis] >= highest[axis] + 1)
+			{
+				return false;
+			}
+			continue;
+		}
+		float enterDistance = (lowest[axis] - origin[axis]) / direction[axis];
+		float leaveDistance = (highest[axis] + 1 - origin[axis]) / direction[axis];
+		if(enterDistance > leaveDistance)
+		{
+			std::swap(enterDistance, leaveDistance);
+		}
+		if(enterDistance > distance)
+		{
+			distance = enterDistance;
+			entryAxis = axis;
+		}
+		furthest = std::min(furthest, leaveDistance);
+	}
+	if(distance > furthest)
+	{
+		return false;
+	}
+
+	int cell[3];
+	int step[3];
+	//distance along the ray to the next cell boundary of each axis and between boundaries
+	float nextBoundary[3];
+	float boundaryGap[3];
+	int normal[3] = {0, 0, 0};
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		//clamped before converting since a ray that starts far away may be outside of what an int holds
+		const float start = floor(origin[axis] + distance * direction[axis]);
+		cell[axis] = static_cast<int>(std::min(std::max(start, static_cast<float>(lowest[axis])), static_cast<float>(highest[axis])));
+	}
+	if(entryAxis >= 0)
+	{
+		cell[entryAxis] = direction[entryAxis] > 0 ? lowest[entryAxis] : highest[entryAxis];
+		normal[entryAxis] = direction[entryAxis] > 0 ? -1 : 1;
+	}
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		if(direction[axis] == 0)
+		{
+			step[axis] = 0;
+			nextBoundary[axis] = FLT_MAX;
+			boundaryGap[axis] = FLT_MAX;
+			continue;
+		}
+		step[axis] = direction[axis] > 0 ? 1 : -1;
+		const float boundary = static_cast<float>(direction[axis] > 0 ? cell[axis] + 1 : cell[axis]);
+		nextBoundary[axis] = (boundary - origin[axis]) / direction[axis];
+		boundaryGap[axis] = 1 / fabs(direction[axis]);
+	}
+
+	for(;;)
+	{
+		//the cells are all inside of the voxels' bounds, which keys always hold
+		const unsigned long long key = GetKey(Vector3(static_cast<float>(cell[0]), static_cast<float>(cell[1]), static_cast<float>(cell[2])));
+		const unsigned slot = FindSlot(key);
+		if(keys[slot] == key)
+		{
+			hit->voxel = &voxelData[indices[slot]];
+			hit->distance = distance;
+			hit->normal = Vector3(static_cast<float>(normal[0]), static_cast<float>(normal[1]), static_cast<float>(normal[2]));
+			return true;
+		}
+
+		int axis = nextBoundary[0] < nextBoundary[1] ? 0 : 1;
+		if(nextBoundary[2] < nextBoundary[axis])
+		{
+			axis = 2;
+		}
+		distance = nextBoundary[axis];
+		if(distance > furthest)
+		{
+			return false;
+		}
+		cell[axis] += step[axis];
+		nextBoundary[axis] += boundaryGap[axis];
+		normal[0] = 0;
+		normal[1] = 0;
+		normal[2] = 0;
+		normal[axis] = -step[axis];
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the vector of voxels the grid contains
+*/
+/****************************************************************************/
+std::vector<Voxel*>& VoxelHashGrid::GetVector()
+{
+	//adding voxels can move them so the pointers are only made when they are asked for
+	if(dirty)
+	{
+		dirty = false;
+		voxels.clear();
+		voxels.reserve(voxelData.size());
+		for(std::vector<Voxel>::iterator voxel = voxelData.begin(); voxel != voxelData.end(); ++voxel)
+		{
+			voxels.push_back(&*voxel);
+		}
+	}
+	return voxels;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of voxels in the grid
+*/
+/****************************************************************************/
+unsigned VoxelHashGrid::GetSize() const
+{
+	return voxelData.size();
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of bytes used by the table and voxels of the grid
+*/
+/****************************************************************************/
+unsigned VoxelHashGrid::GetMemoryUsed() const
+{
+	return keys.capacity() * sizeof(unsigned long long) + indices.capacity() * sizeof(unsigned) + voxelData.capacity() * sizeof(Voxel) + voxels.capacity() * sizeof(Voxel*);
+}
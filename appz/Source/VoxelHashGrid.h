@@ -0,0 +1,54 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file VoxelHashGrid.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A hash table of voxels keyed on their position
+*/
+/****************************************************************************/
+#include <vector>
+#include "Voxel.h"
+#include "VoxelRay.h"
+#include "BoundingBox.h"
+/****************************************************************************/
+/*!
+Class VoxelHashGrid:
+\brief
+Finds voxels by their position in constant time. Positions are packed 21
+bits per axis into a 64 bit key, so every axis has to be within
+-2^20 and 2^20 - 1. Voxels outside of that are left out. The keys are stored in an open addressing table with
+linear probing that holds the index of each voxel in a packed array.
+Works the same way as VoxelOctree: the first voxel added at a position is
+kept.
+*/
+/****************************************************************************/
+class VoxelHashGrid
+{
+public:
+	VoxelHashGrid(const unsigned expectedNumOfVoxels = 0);
+	VoxelHashGrid(VoxelHashGrid& grid);
+	void operator=(VoxelHashGrid& grid);
+	~VoxelHashGrid();
+	void AddVoxel(const Voxel& voxel);
+	Voxel* GetVoxel(const Vector3& position);
+	bool Raycast(const VoxelRay& ray, VoxelRayHit* hit);
+	std::vector<Voxel*>& GetVector();
+	unsigned GetSize() const;
+	unsigned GetMemoryUsed() const;
+private:
+	static unsigned long long GetKey(const Vector3& position);
+	unsigned FindSlot(const unsigned long long key) const;
+	void Rehash(const unsigned newNumOfSlots);
+
+	//a slot holds the key of a voxel and its index in voxelData, emptyKey marks empty slots
+	std::vector<unsigned long long> keys;
+	std::vector<unsigned> indices;
+	std::vector<Voxel> voxelData;
+	std::vector<Voxel*> voxels;
+	//the cells the voxels are in, which rays are clipped to
+	BoundingBox<int> bounds;
+	//whether voxels were added since the pointers in voxels were made
+	bool dirty;
+};
@@ -1,5 +1,8 @@
 #include "VoxelOctree.h"
-#include "timer.h"
+#include "RadixSort.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
 /****************************************************************************/
 /*!
 \file VoxelOctree.cpp
@@ -10,6 +13,39 @@ An octree made specifically for voxels
 */
 /****************************************************************************/
 
+/****************************************************************************/
+/*!
+\brief
+Returns the number of bits set in a child mask
+\param mask
+		the child mask
+*/
+/****************************************************************************/
+static unsigned CountBits(unsigned char mask)
+{
+	unsigned bits = mask;
+	bits = (bits & 0x55) + ((bits >> 1) & 0x55);
+	bits = (bits & 0x33) + ((bits >> 2) & 0x33);
+	return (bits & 0x0F) + (bits >> 4);
+}
+/****************************************************************************/
+/*!
+\brief
+Spreads the lower 21 bits of a value out so there are 2 empty bits between each of them
+\param value
+		the value to spread
+*/
+/****************************************************************************/
+static unsigned long long SpreadBits(unsigned long long value)
+{
+	value &= 0x1FFFFF;
+	value = (value | value << 32) & 0x001F00000000FFFFull;
+	value = (value | value << 16) & 0x001F0000FF0000FFull;
+	value = (value | value << 8) & 0x100F00F00F00F00Full;
+	value = (value | value << 4) & 0x10C30C30C30C30C3ull;
+	value = (value | value << 2) & 0x1249249249249249ull;
+	return value;
+}
 /****************************************************************************/
 /*!
 \brief
@@ -22,6 +58,8 @@ Default constructor
 /****************************************************************************/
 VoxelOctree::VoxelOctree(int diameter, Vector3 displacement)
 	:
+dirty(false),
+depth(1),
 diameter(diameter),
 displacement(displacement)
 {
@@ -37,59 +75,68 @@ VoxelOctree::~VoxelOctree()
 {
 }
 
+/****************************************************************************/
+/*!
+\brief
+Copy constructor. A built tree is copied as it is instead of being rebuilt
+\param tree
+		the tree to copy
+*/
+/****************************************************************************/
 VoxelOctree::VoxelOctree(VoxelOctree& tree)
 	:
+nodes(tree.nodes),
+voxelData(tree.voxelData),
+dirty(tree.dirty),
+depth(tree.depth),
+rangeX(tree.rangeX),
+rangeY(tree.rangeY),
+rangeZ(tree.rangeZ),
 diameter(tree.diameter),
 displacement(tree.displacement)
 {
-	SetRangeTo(diameter, displacement);
-	for(std::vector<Voxel*>::const_iterator it = tree.voxels.begin(), end = tree.voxels.end(); it != end; ++it)
-	{
-		const Voxel& voxel = **it;
-		AddVoxel(voxel);
-	}
+	PointToVoxels();
 }
 
 void VoxelOctree::operator=(VoxelOctree& tree)
 {
+	nodes = tree.nodes;
+	voxelData = tree.voxelData;
+	dirty = tree.dirty;
+	depth = tree.depth;
+	rangeX = tree.rangeX;
+	rangeY = tree.rangeY;
+	rangeZ = tree.rangeZ;
 	diameter = tree.diameter;
 	displacement = tree.displacement;
-
-	SetRangeTo(diameter, displacement);
-	for(std::vector<Voxel*>::const_iterator it = tree.voxels.begin(), end = tree.voxels.end(); it != end; ++it)
-	{
-		const Voxel& voxel = **it;
-		AddVoxel(voxel);
-	}
+	PointToVoxels();
 }
 /****************************************************************************/
 /*!
 \brief
-Sets the first leaf to this range if it has not been initialised yet
+Sets the range of the tree. Voxels that end up outside of the new range
+are dropped on the next lookup
 \param diameter
-		the diameter of the first leaf
+		the diameter of the tree. Rounded up to a power of 2 and capped to 2 to the power of maxVoxelOctreeDepth
 \param displacement
-		the displacement of the leaf in the world
+		the displacement of the tree in the world
 */
 /****************************************************************************/
 void VoxelOctree::SetRangeTo(int diameter, Vector3 displacement)
 {
 	this->diameter = diameter;
 	this->displacement = displacement;
-	Range<int> fullRangeX(1,1);
-	Range<int> fullRangeY(1,1);
-	Range<int> fullRangeZ(1,1);
-	while(fullRangeX.Length() <= diameter)
+
+	depth = 1;
+	while(depth < maxVoxelOctreeDepth && (1 << depth) <= diameter)
 	{
-		int newEnd = fullRangeX.end * 2;
-		fullRangeX.end = newEnd;
-		fullRangeY.end = newEnd;
-		fullRangeZ.end = newEnd;
+		++depth;
 	}
-	fullRangeX.Set(fullRangeX.start + displacement.x - 1, fullRangeX.end + displacement.x - 1);
-	fullRangeY.Set(fullRangeY.start + displacement.y - 1, fullRangeY.end + displacement.y - 1);
-	fullRangeZ.Set(fullRangeZ.start + displacement.z - 1, fullRangeZ.end + displacement.z - 1);
-	mainLeaf.SetRangeTo(fullRangeX, fullRangeY, fullRangeZ);
+	const int side = 1 << depth;
+	rangeX.Set(static_cast<int>(displacement.x), static_cast<int>(displacement.x) + side - 1);
+	rangeY.Set(static_cast<int>(displacement.y), static_cast<int>(displacement.y) + side - 1);
+	rangeZ.Set(static_cast<int>(displacement.z), static_cast<int>(displacement.z) + side - 1);
+	dirty = true;
 }
 /****************************************************************************/
 /*!
@@ -99,23 +146,187 @@ Returns the radius of the tree
 /****************************************************************************/
 int VoxelOctree::GetRadius() const
 {
-	return mainLeaf.GetRadius();
+	return (1 << depth) / 2;
 }
 /****************************************************************************/
 /*!
 \brief
-Add a voxel to the tree
+Add a voxel to the tree. If there is already a voxel at its position, the
+first one added is kept
 \param voxel
 		the voxel to be added
 */
 /****************************************************************************/
 void VoxelOctree::AddVoxel(const Voxel& voxel)
 {
-	mainLeaf.AddVoxel(voxel);
-	voxels.push_back(mainLeaf.GetVoxel(voxel.GetPosition()));
-	if(voxels.back() == NULL)
+	if(!voxel.GetSolidness())
 	{
-		throw;
+		return;
+	}
+	voxelData.push_back(voxel);
+	dirty = true;
+}
+/****************************************************************************/
+/*!
+\brief
+Replaces the voxels of the tree with an array of voxels and builds the tree
+from them right away. This is the fastest way to fill a tree. If several
+voxels share a position, the first one in the array is kept
+\param begin
+		the first voxel
+\param end
+		one past the last voxel
+*/
+/****************************************************************************/
+void VoxelOctree::BuildFrom(const Voxel* begin, const Voxel* end)
+{
+	voxelData.clear();
+	voxelData.reserve(end - begin);
+	for(const Voxel* voxel = begin; voxel != end; ++voxel)
+	{
+		if(voxel->GetSolidness())
+		{
+			voxelData.push_back(*voxel);
+		}
+	}
+	Build();
+}
+/****************************************************************************/
+/*!
+\brief
+Turns a position in the world into a position from the corner of the tree
+\param position
+		the position in the world
+\param x, y, z
+		where the position from the corner is written to
+\return
+		false if the position is outside of the tree
+*/
+/****************************************************************************/
+bool VoxelOctree::GetLocalPosition(const Vector3& position, unsigned* x, unsigned* y, unsigned* z) const
+{
+	const int positionX = static_cast<int>(position.x);
+	const int positionY = static_cast<int>(position.y);
+	const int positionZ = static_cast<int>(position.z);
+	if(!rangeX.IsInRange(positionX) || !rangeY.IsInRange(positionY) || !rangeZ.IsInRange(positionZ))
+	{
+		return false;
+	}
+	*x = positionX - rangeX.start;
+	*y = positionY - rangeY.start;
+	*z = positionZ - rangeZ.start;
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Rebuilds the nodes from the voxels. The voxels are radix sorted by their
+morton code so the voxels of every node end up next to each other. The
+nodes are then made from the bottom level up, each level by merging the
+codes of the level below that share a parent, which takes time linear in
+the number of voxels and nodes
+*/
+/****************************************************************************/
+void VoxelOctree::Build()
+{
+	dirty = false;
+	nodes.clear();
+
+	std::vector<unsigned long long> codes;
+	std::vector<unsigned> indices;
+	codes.reserve(voxelData.size());
+	indices.reserve(voxelData.size());
+	for(unsigned index = 0; index < voxelData.size(); ++index)
+	{
+		unsigned x, y, z;
+		if(GetLocalPosition(voxelData[index].GetPosition(), &x, &y, &z))
+		{
+			codes.push_back(SpreadBits(x) << 2 | SpreadBits(y) << 1 | SpreadBits(z));
+			indices.push_back(index);
+		}
+	}
+	if(codes.empty())
+	{
+		voxelData.clear();
+		PointToVoxels();
+		return;
+	}
+	RadixSort(codes, indices, 3 * depth);
+
+	//the sort keeps the order the voxels were added in so the first voxel at every position comes first
+	std::vector<Voxel> sortedVoxels;
+	std::vector<unsigned long long> keys;
+	sortedVoxels.reserve(codes.size());
+	keys.reserve(codes.size());
+	for(unsigned index = 0; index < codes.size(); ++index)
+	{
+		if(index && codes[index] == codes[index - 1])
+		{
+			continue;
+		}
+		sortedVoxels.push_back(voxelData[indices[index]]);
+		keys.push_back(codes[index]);
+	}
+	voxelData.swap(sortedVoxels);
+
+	//levels[0] is the level right above the voxels and the last level holds the root
+	std::vector<std::vector<SVONode> > levels(depth);
+	std::vector<unsigned long long> parentKeys;
+	for(unsigned level = 0; level < depth; ++level)
+	{
+		std::vector<SVONode>& levelNodes = levels[level];
+		parentKeys.clear();
+		for(unsigned index = 0; index < keys.size(); ++index)
+		{
+			const unsigned long long parentKey = keys[index] >> 3;
+			if(parentKeys.empty() || parentKeys.back() != parentKey)
+			{
+				SVONode node;
+				node.firstChild = index;
+				node.childMask = 0;
+				levelNodes.push_back(node);
+				parentKeys.push_back(parentKey);
+			}
+			levelNodes.back().childMask |= 1 << (keys[index] & 7);
+		}
+		keys.swap(parentKeys);
+	}
+
+	//the levels are laid out from the root down so the children of a node are found after it
+	unsigned numOfNodes = 0;
+	for(unsigned level = 0; level < depth; ++level)
+	{
+		numOfNodes += levels[level].size();
+	}
+	nodes.reserve(numOfNodes);
+	for(unsigned level = depth; level-- > 0;)
+	{
+		const unsigned levelBegin = nodes.size();
+		for(std::vector<SVONode>::const_iterator node = levels[level].begin(); node != levels[level].end(); ++node)
+		{
+			nodes.push_back(*node);
+			//the level right above the voxels points into the voxel array as it is
+			if(level)
+			{
+				nodes.back().firstChild += levelBegin + levels[level].size();
+			}
+		}
+	}
+	PointToVoxels();
+}
+/****************************************************************************/
+/*!
+\brief
+Makes the vector of pointers point at the voxels of this tree
+*/
+/****************************************************************************/
+void VoxelOctree::PointToVoxels()
+{
+	voxels.clear();
+	voxels.reserve(voxelData.size());
+	for(std::vector<Voxel>::iterator voxel = voxelData.begin(); voxel != voxelData.end(); ++voxel)
+	{
+		voxels.push_back(&*voxel);
 	}
 }
 /****************************************************************************/
@@ -126,6 +337,10 @@ Returns the vector of voxels the tree contains
 /****************************************************************************/
 std::vector<Voxel*>& VoxelOctree::GetVector()
 {
+	if(dirty)
+	{
+		Build();
+	}
 	return voxels;
 }
 /****************************************************************************/
@@ -138,9 +353,201 @@ Returns the voxel at the specified position
 /****************************************************************************/
 Voxel* VoxelOctree::GetVoxel(const Vector3& position)
 {
-	if(!mainLeaf.GetRangeX().IsInRange(position.x) || !mainLeaf.GetRangeY().IsInRange(position.y) || !mainLeaf.GetRangeZ().IsInRange(position.z))
+	if(dirty)
+	{
+		Build();
+	}
+	unsigned x, y, z;
+	if(nodes.empty() || !GetLocalPosition(position, &x, &y, &z))
 	{
 		return NULL;
 	}
-	return mainLeaf.GetVoxel(position);
-}
\ No newline at end of file
+
+	unsigned nodeIndex = 0;
+	for(unsigned level = 0; level < depth; ++level)
+	{
+		const unsigned shift = depth - 1 - level;
+		const unsigned char bit = 1 << (((x >> shift) & 1) << 2 | ((y >> shift) & 1) << 1 | ((z >> shift) & 1));
+		const SVONode& node = nodes[nodeIndex];
+		if(!(node.childMask & bit))
+		{
+			return NULL;
+		}
+		//the children before this one are the set bits below it
+		const unsigned child = node.firstChild + CountBits(node.childMask & (bit - 1));
+		if(level + 1 == depth)
+		{
+			return &voxelData[child];
+		}
+		nodeIndex = child;
+	}
+	return NULL;
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the first voxel a ray hits. The ray steps through the tree like a
+3D DDA, but each step skips the whole empty node the ray is in instead of
+a single cell, and only the nodes below the last one the old and new cell
+share are walked again. Safe to call from several threads at once as long
+as the tree is not dirty
+\param ray
+		the ray to cast
+\param hit
+		where the voxel hit is written to
+\return
+		whether a voxel was hit
+*/
+/****************************************************************************/
+bool VoxelOctree::Raycast(const VoxelRay& ray, VoxelRayHit* hit)
+{
+	if(dirty)
+	{
+		Build();
+	}
+	hit->voxel = NULL;
+	const float length = ray.direction.Length();
+	if(nodes.empty() || length == 0)
+	{
+		return false;
+	}
+
+	//the ray from the corner of the tree where the cell of every voxel starts at its position
+	const float direction[3] = {ray.direction.x / length, ray.direction.y / length, ray.direction.z / length};
+	const float origin[3] = {ray.origin.x - rangeX.start + 0.5f, ray.origin.y - rangeY.start + 0.5f, ray.origin.z - rangeZ.start + 0.5f};
+	const int side = 1 << depth;
+
+	//clip the ray to the bounds of the tree
+	float distance = 0;
+	float furthest = ray.maxDistance;
+	int entryAxis = -1;
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		if(direction[axis] == 0)
+		{
+			if(origin[axis] < 0 || origin[axis] >= side)
+			{
+				return false;
+			}
+			continue;
+		}
+		float enterDistance = -origin[axis] / direction[axis];
+		float leaveDistance = (side - origin[axis]) / direction[axis];
+		if(enterDistance > leaveDistance)
+		{
+			std::swap(enterDistance, leaveDistance);
+		}
+		if(enterDistance > distance)
+		{
+			distance = enterDistance;
+			entryAxis = axis;
+		}
+		furthest = std::min(furthest, leaveDistance);
+	}
+	if(distance > furthest)
+	{
+		return false;
+	}
+
+	int cell[3];
+	int normal[3] = {0, 0, 0};
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		cell[axis] = std::min(std::max(static_cast<int>(floor(origin[axis] + distance * direction[axis])), 0), side - 1);
+	}
+	if(entryAxis >= 0)
+	{
+		cell[entryAxis] = direction[entryAxis] > 0 ? 0 : side - 1;
+		normal[entryAxis] = direction[entryAxis] > 0 ? -1 : 1;
+	}
+
+	//the nodes from the root down to the one the ray is in
+	unsigned path[maxVoxelOctreeDepth];
+	path[0] = 0;
+	unsigned level = 0;
+	for(;;)
+	{
+		unsigned shift = depth - 1 - level;
+		for(;;)
+		{
+			const unsigned char bit = 1 << (((cell[0] >> shift) & 1) << 2 | ((cell[1] >> shift) & 1) << 1 | ((cell[2] >> shift) & 1));
+			const SVONode& node = nodes[path[level]];
+			if(!(node.childMask & bit))
+			{
+				break;
+			}
+			const unsigned child = node.firstChild + CountBits(node.childMask & (bit - 1));
+			if(level + 1 == depth)
+			{
+				hit->voxel = &voxelData[child];
+				hit->distance = distance;
+				hit->normal = Vector3(static_cast<float>(normal[0]), static_cast<float>(normal[1]), static_cast<float>(normal[2]));
+				return true;
+			}
+			path[++level] = child;
+			--shift;
+		}
+
+		//the cell is in an empty child of the node so step out of the whole child
+		const int size = 1 << shift;
+		int low[3];
+		float exitDistance = FLT_MAX;
+		int exitAxis = 0;
+		for(int axis = 0; axis < 3; ++axis)
+		{
+			low[axis] = cell[axis] >> shift << shift;
+			if(direction[axis] == 0)
+			{
+				continue;
+			}
+			const float boundary = static_cast<float>(direction[axis] > 0 ? low[axis] + size : low[axis]);
+			const float axisDistance = (boundary - origin[axis]) / direction[axis];
+			if(axisDistance < exitDistance)
+			{
+				exitDistance = axisDistance;
+				exitAxis = axis;
+			}
+		}
+		if(exitDistance > furthest)
+		{
+			return false;
+		}
+		distance = std::max(distance, exitDistance);
+
+		int next[3];
+		for(int axis = 0; axis < 3; ++axis)
+		{
+			//the position is kept inside the face the ray left through so rounding never skips a cell
+			next[axis] = std::min(std::max(static_cast<int>(floor(origin[axis] + distance * direction[axis])), low[axis]), low[axis] + size - 1);
+			normal[axis] = 0;
+		}
+		next[exitAxis] = direction[exitAxis] > 0 ? low[exitAxis] + size : low[exitAxis] - 1;
+		normal[exitAxis] = direction[exitAxis] > 0 ? -1 : 1;
+		if(next[exitAxis] < 0 || next[exitAxis] >= side)
+		{
+			return false;
+		}
+
+		//go back up to the deepest node that holds both cells
+		unsigned difference = (cell[0] ^ next[0]) | (cell[1] ^ next[1]) | (cell[2] ^ next[2]);
+		unsigned highestBit = 0;
+		while(difference >>= 1)
+		{
+			++highestBit;
+		}
+		level = std::min(level, depth - 1 - highestBit);
+		cell[0] = next[0];
+		cell[1] = next[1];
+		cell[2] = next[2];
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of bytes used by the nodes and voxels of the tree
+*/
+/****************************************************************************/
+unsigned VoxelOctree::GetMemoryUsed() const
+{
+	return nodes.capacity() * sizeof(SVONode) + voxelData.capacity() * sizeof(Voxel) + voxels.capacity() * sizeof(Voxel*);
+}
@@ -8,19 +8,50 @@
 An octree made specifically for voxels
 */
 /****************************************************************************/
-#include "VoxelLeaf.h"
+#include <vector>
+#include "Voxel.h"
+#include "VoxelRay.h"
+#include "Range.h"
+/****************************************************************************/
+/*!
+\brief
+the deepest the voxelOctree can go. Positions are packed 21 bits per axis
+into a 64 bit morton code
+*/
+/****************************************************************************/
+const unsigned maxVoxelOctreeDepth = 21;
 /****************************************************************************/
 /*!
 \brief
 the default diameter of our voxelOctree
 */
 /****************************************************************************/
-const int defaultDiameter = pow(2.0, 24.0);
+const int defaultDiameter = 1 << (maxVoxelOctreeDepth - 1);
+/****************************************************************************/
+/*!
+Class SVONode:
+\brief
+A node of the voxelOctree. Only the children that hold voxels exist and
+they are stored next to each other, starting at firstChild. The nth bit of
+childMask is set if the nth child exists.
+*/
+/****************************************************************************/
+class SVONode
+{
+public:
+	//index of the first child in the node array, or in the voxel array for the nodes right above the voxels
+	unsigned firstChild;
+	unsigned char childMask;
+};
 /****************************************************************************/
 /*!
 Class VoxelOctree:
 \brief
-An octree made specifically for voxels
+An octree made specifically for voxels. The nodes are kept in a single
+array in breadth first order and the voxels are packed in a separate array
+in morton order. Added voxels are held back until the next lookup, when
+the whole tree is rebuilt from them at once. BuildFrom fills the tree from
+an array of voxels in one go.
 */
 /****************************************************************************/
 class VoxelOctree
@@ -32,12 +63,27 @@ public:
 	~VoxelOctree();
 	void SetRangeTo(int diameter, Vector3 displacement);
 	void AddVoxel(const Voxel& voxel);
+	void BuildFrom(const Voxel* begin, const Voxel* end);
 	Voxel* GetVoxel(const Vector3& position);
+	bool Raycast(const VoxelRay& ray, VoxelRayHit* hit);
 	std::vector<Voxel*>& GetVector();
 	int GetRadius() const;
+	unsigned GetMemoryUsed() const;
 private:
-	VoxelLeaf mainLeaf;
+	void Build();
+	void PointToVoxels();
+	bool GetLocalPosition(const Vector3& position, unsigned* x, unsigned* y, unsigned* z) const;
+
+	std::vector<SVONode> nodes;
+	std::vector<Voxel> voxelData;
 	std::vector<Voxel*> voxels;
+	//whether voxels were added since the tree was last built
+	bool dirty;
+	//number of levels between the root and the voxels
+	unsigned depth;
+	Range<int> rangeX;
+	Range<int> rangeY;
+	Range<int> rangeZ;
 	int diameter;
 	Vector3 displacement;
-};
\ No newline at end of file
+};
@@ -0,0 +1,373 @@
+#include "VoxelPager.h"
+#include <cmath>
+/****************************************************************************/
+/*!
+\file VoxelPager.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Keeps the chunks of a voxel world that are needed in memory
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param file
+		an open file the world is stored in
+\param displacement
+		position of the corner of the world
+\param memoryBudget
+		number of bytes of chunks that can be mapped at once
+*/
+/****************************************************************************/
+VoxelPager::VoxelPager(VoxelChunkFile* file, Vector3 displacement, unsigned memoryBudget)
+	:
+file(file),
+displacement(displacement),
+maxResidentChunks(memoryBudget / voxelChunkBytes),
+writing(false),
+stopping(false),
+numOfPageIns(0),
+numOfPageOuts(0)
+{
+	if(maxResidentChunks == 0)
+	{
+		maxResidentChunks = 1;
+	}
+	writer = std::thread(&VoxelPager::WriterLoop, this);
+}
+/****************************************************************************/
+/*!
+\brief
+Pages out every chunk and stops the writer
+*/
+/****************************************************************************/
+VoxelPager::~VoxelPager()
+{
+	Flush();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+	writer.join();
+}
+/****************************************************************************/
+/*!
+\brief
+Pages in the stored chunks around a position, so they are ready before
+they are needed and are the last to be paged out
+\param position
+		usually the position of the camera
+\param radius
+		number of chunks around the chunk of the position to page in. The
+		memory budget should fit (radius * 2 + 1) ^ 3 chunks
+*/
+/****************************************************************************/
+void VoxelPager::UpdateTo(const Vector3& position, const int radius)
+{
+	const int centreX = static_cast<int>(floor((position.x - displacement.x) / voxelChunkSize));
+	const int centreY = static_cast<int>(floor((position.y - displacement.y) / voxelChunkSize));
+	const int centreZ = static_cast<int>(floor((position.z - displacement.z) / voxelChunkSize));
+	const int chunksX = file->GetNumOfChunks(0);
+	const int chunksY = file->GetNumOfChunks(1);
+	const int chunksZ = file->GetNumOfChunks(2);
+
+	for(int z = centreZ - radius; z <= centreZ + radius; ++z)
+	{
+		for(int y = centreY - radius; y <= centreY + radius; ++y)
+		{
+			for(int x = centreX - radius; x <= centreX + radius; ++x)
+			{
+				if(x < 0 || y < 0 || z < 0 || x >= chunksX || y >= chunksY || z >= chunksZ)
+				{
+					continue;
+				}
+				const unsigned chunk = (z * chunksY + y) * chunksX + x;
+				if(file->HasChunk(chunk))
+				{
+					PageIn(chunk, false, true);
+				}
+			}
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Gets the voxel at a position, paging in its chunk if it has to
+\param position
+		the position of the voxel
+\param voxel
+		where the voxel is written to
+\return
+		false if there is no voxel there
+*/
+/****************************************************************************/
+bool VoxelPager::GetVoxel(const Vector3& position, Voxel* voxel)
+{
+	unsigned chunk, cell;
+	if(!GetChunkOf(position, &chunk, &cell) || !file->HasChunk(chunk))
+	{
+		return false;
+	}
+	const ResidentChunk* resident = PageIn(chunk, false, false);
+	if(!resident || !resident->cells[cell].solidness)
+	{
+		return false;
+	}
+
+	const VoxelCell& stored = resident->cells[cell];
+	voxel->SetPositionTo(Vector3(floor(position.x), floor(position.y), floor(position.z)));
+	voxel->SetColorTo(Color(stored.red / 255.0f, stored.green / 255.0f, stored.blue / 255.0f));
+	voxel->SetSolidityTo(stored.solidness);
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Stores a voxel in the world, replacing the voxel at its position. A voxel
+with no solidness removes the voxel there
+\param voxel
+		the voxel to be stored
+*/
+/****************************************************************************/
+void VoxelPager::SetVoxel(const Voxel& voxel)
+{
+	unsigned chunk, cell;
+	if(!GetChunkOf(voxel.GetPosition(), &chunk, &cell))
+	{
+		return;
+	}
+	//removing a voxel from a chunk that was never stored changes nothing
+	if(!voxel.GetSolidness() && !file->HasChunk(chunk))
+	{
+		return;
+	}
+	ResidentChunk* resident = PageIn(chunk, true, false);
+	if(!resident)
+	{
+		return;
+	}
+
+	const Color color = voxel.GetColor();
+	VoxelCell& stored = resident->cells[cell];
+	stored.red = static_cast<unsigned char>(color.r * 255 + 0.5f);
+	stored.green = static_cast<unsigned char>(color.g * 255 + 0.5f);
+	stored.blue = static_cast<unsigned char>(color.b * 255 + 0.5f);
+	stored.solidness = voxel.GetSolidness();
+	resident->dirty = true;
+}
+/****************************************************************************/
+/*!
+\brief
+Pages out every chunk and waits until they are all written to the disk
+*/
+/****************************************************************************/
+void VoxelPager::Flush()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for(std::map<unsigned, ResidentChunk>::const_iterator resident = residents.begin(); resident != residents.end(); ++resident)
+		{
+			pageOuts.push_back(resident->second);
+		}
+		numOfPageOuts += residents.size();
+		residents.clear();
+		uses.clear();
+
+		workReady.notify_all();
+		while(!pageOuts.empty() || writing)
+		{
+			pageOutDone.wait(lock);
+		}
+	}
+	file->Flush();
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of chunks that are mapped in
+*/
+/****************************************************************************/
+unsigned VoxelPager::GetNumOfResidentChunks() const
+{
+	return residents.size();
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of times a chunk was paged in
+*/
+/****************************************************************************/
+unsigned VoxelPager::GetNumOfPageIns() const
+{
+	return numOfPageIns;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the number of times a chunk was paged out
+*/
+/****************************************************************************/
+unsigned VoxelPager::GetNumOfPageOuts() const
+{
+	return numOfPageOuts;
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the chunk a position is in and the cell of the position in it
+\param position
+		the position in the world
+\param chunk
+		where the index of the chunk is written to
+\param cell
+		where the index of the cell in the chunk is written to
+\return
+		false if the position is outside of the world
+*/
+/****************************************************************************/
+bool VoxelPager::GetChunkOf(const Vector3& position, unsigned* chunk, unsigned* cell) const
+{
+	//floored like UpdateTo so both agree on the chunk of a negative position
+	const float worldX = floor(position.x - displacement.x);
+	const float worldY = floor(position.y - displacement.y);
+	const float worldZ = floor(position.z - displacement.z);
+	const int chunksX = file->GetNumOfChunks(0);
+	const int chunksY = file->GetNumOfChunks(1);
+	const int chunksZ = file->GetNumOfChunks(2);
+	//checked before converting since a position far outside of the world may not fit in an int
+	if(!(worldX >= 0 && worldY >= 0 && worldZ >= 0 && worldX < chunksX * voxelChunkSize && worldY < chunksY * voxelChunkSize && worldZ < chunksZ * voxelChunkSize))
+	{
+		return false;
+	}
+	const int x = static_cast<int>(worldX);
+	const int y = static_cast<int>(worldY);
+	const int z = static_cast<int>(worldZ);
+
+	*chunk = (z / voxelChunkSize * chunksY + y / voxelChunkSize) * chunksX + x / voxelChunkSize;
+	*cell = ((x % voxelChunkSize) * voxelChunkSize + z % voxelChunkSize) * voxelChunkSize + y % voxelChunkSize;
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Marks a chunk as the most recently used, mapping it in if it is not
+resident yet. Mapping a chunk in may page out the least recently used one
+\param chunk
+		index of the chunk
+\param create
+		whether to store the chunk in the file if it is not stored yet
+\param prefetch
+		whether to have the writer read a newly mapped chunk in from the
+		disk, for chunks that are not needed right away
+\return
+		the resident chunk, or NULL if it could not be mapped
+*/
+/****************************************************************************/
+ResidentChunk* VoxelPager::PageIn(const unsigned chunk, const bool create, const bool prefetch)
+{
+	std::map<unsigned, ResidentChunk>::iterator found = residents.find(chunk);
+	if(found != residents.end())
+	{
+		uses.splice(uses.begin(), uses, found->second.use);
+		return &found->second;
+	}
+
+	VoxelCell* cells = file->MapChunk(chunk, create);
+	if(!cells)
+	{
+		return NULL;
+	}
+	++numOfPageIns;
+	while(residents.size() >= maxResidentChunks)
+	{
+		PageOutLeastUsed();
+	}
+
+	uses.push_front(chunk);
+	ResidentChunk& resident = residents[chunk];
+	resident.cells = cells;
+	resident.dirty = false;
+	resident.use = uses.begin();
+
+	//the writer always reads a chunk in before it gets to paging it out since the prefetch is queued first
+	if(prefetch)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			prefetches.push_back(cells);
+		}
+		workReady.notify_all();
+	}
+	return &resident;
+}
+/****************************************************************************/
+/*!
+\brief
+Hands the least recently used chunk to the writer
+*/
+/****************************************************************************/
+void VoxelPager::PageOutLeastUsed()
+{
+	const unsigned chunk = uses.back();
+	uses.pop_back();
+	std::map<unsigned, ResidentChunk>::iterator resident = residents.find(chunk);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pageOuts.push_back(resident->second);
+	}
+	workReady.notify_all();
+	residents.erase(resident);
+	++numOfPageOuts;
+}
+/****************************************************************************/
+/*!
+\brief
+Reads in the chunks paged in around the camera, and writes and unmaps the
+chunks that were paged out, until the pager is destroyed. A chunk that is
+paged in again before the writer gets to it gets a view of its own, which
+sees the same memory
+*/
+/****************************************************************************/
+void VoxelPager::WriterLoop()
+{
+	std::vector<ResidentChunk> batch;
+	std::vector<VoxelCell*> prefetchBatch;
+	std::unique_lock<std::mutex> lock(mutex);
+	for(;;)
+	{
+		while(!stopping && pageOuts.empty() && prefetches.empty())
+		{
+			workReady.wait(lock);
+		}
+		if(pageOuts.empty() && prefetches.empty())
+		{
+			return;
+		}
+		batch.swap(pageOuts);
+		prefetchBatch.swap(prefetches);
+		writing = true;
+		lock.unlock();
+
+		//prefetches go first since a chunk in this batch of page outs may have been queued to be read in too
+		for(std::vector<VoxelCell*>::const_iterator cells = prefetchBatch.begin(); cells != prefetchBatch.end(); ++cells)
+		{
+			VoxelChunkFile::PrefetchChunk(*cells);
+		}
+		prefetchBatch.clear();
+
+		for(std::vector<ResidentChunk>::const_iterator chunk = batch.begin(); chunk != batch.end(); ++chunk)
+		{
+			VoxelChunkFile::UnmapChunk(chunk->cells, chunk->dirty);
+		}
+		batch.clear();
+
+		lock.lock();
+		writing = false;
+		pageOutDone.notify_all();
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file VoxelPager.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Keeps the chunks of a voxel world that are needed in memory
+*/
+/****************************************************************************/
+#include "VoxelChunkFile.h"
+#include <map>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//a chunk that is mapped into memory
+class ResidentChunk
+{
+public:
+	VoxelCell* cells;
+	//whether a voxel was set since the chunk was paged in
+	bool dirty;
+	//where the chunk is in the list of uses
+	std::list<unsigned>::iterator use;
+};
+/****************************************************************************/
+/*!
+Class VoxelPager:
+\brief
+A world of voxels stored in a VoxelChunkFile. Chunks are mapped in when they
+are used or when the camera gets near them, and the least recently used
+chunks are paged out once more chunks are mapped than the memory budget
+allows. Paging out writes the chunk to the disk, and chunks mapped in around
+the camera are read in from the disk ahead of time. Both are done on a
+thread of its own so that the game does not wait on them.
+*/
+/****************************************************************************/
+class VoxelPager
+{
+public:
+	VoxelPager(VoxelChunkFile* file, Vector3 displacement = Vector3(), unsigned memoryBudget = 64 * voxelChunkBytes);
+	~VoxelPager();
+	void UpdateTo(const Vector3& position, const int radius);
+	bool GetVoxel(const Vector3& position, Voxel* voxel);
+	void SetVoxel(const Voxel& voxel);
+	void Flush();
+	unsigned GetNumOfResidentChunks() const;
+	unsigned GetNumOfPageIns() const;
+	unsigned GetNumOfPageOuts() const;
+private:
+	VoxelPager(const VoxelPager&);
+	VoxelPager& operator=(const VoxelPager&);
+
+	bool GetChunkOf(const Vector3& position, unsigned* chunk, unsigned* cell) const;
+	ResidentChunk* PageIn(const unsigned chunk, const bool create, const bool prefetch);
+	void PageOutLeastUsed();
+	void WriterLoop();
+
+	VoxelChunkFile* file;
+	Vector3 displacement;
+	unsigned maxResidentChunks;
+	std::map<unsigned, ResidentChunk> residents;
+	//indices of the resident chunks, the most recently used first
+	std::list<unsigned> uses;
+
+	//chunks waiting for the writer to page them out
+	std::vector<ResidentChunk> pageOuts;
+	//views of chunks waiting for the writer to read them in
+	std::vector<VoxelCell*> prefetches;
+	std::thread writer;
+	std::mutex mutex;
+	std::condition_variable workReady;
+	std::condition_variable pageOutDone;
+	bool writing;
+	bool stopping;
+
+	unsigned numOfPageIns;
+	unsigned numOfPageOuts;
+};
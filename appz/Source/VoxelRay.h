@@ -0,0 +1,45 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file VoxelRay.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Rays cast through voxels and what they hit
+*/
+/****************************************************************************/
+#include "Voxel.h"
+/****************************************************************************/
+/*!
+Class VoxelRay:
+\brief
+A ray cast through voxels. The direction does not have to be normalized
+but distances along the ray are in world units either way. Voxels take up
+the space within half a unit of their position.
+*/
+/****************************************************************************/
+class VoxelRay
+{
+public:
+	Vector3 origin;
+	Vector3 direction;
+	//how far along the ray to look for voxels
+	float maxDistance;
+};
+/****************************************************************************/
+/*!
+Class VoxelRayHit:
+\brief
+The first voxel a ray hits. voxel is NULL if the ray hit nothing, in which
+case the rest is left as it was.
+*/
+/****************************************************************************/
+class VoxelRayHit
+{
+public:
+	Voxel* voxel;
+	//distance along the ray to where it entered the voxel
+	float distance;
+	//normal of the face the ray entered the voxel through. It is a zero vector if the ray started inside the voxel
+	Vector3 normal;
+};
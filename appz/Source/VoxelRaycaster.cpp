@@ -0,0 +1,97 @@
+#include "VoxelRaycaster.h"
+/****************************************************************************/
+/*!
+\file VoxelRaycaster.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Casts many rays through a voxelOctree at once
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param numOfWorkers
+		number of threads that cast rays, 0 to use one for every core
+*/
+/****************************************************************************/
+VoxelRaycaster::VoxelRaycaster(const unsigned numOfWorkers)
+	:
+threadPool(numOfWorkers),
+octree(NULL),
+rays(NULL),
+hits(NULL)
+{
+	nextBatch = 0;
+	numOfHits = 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+VoxelRaycaster::~VoxelRaycaster()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Casts every ray through a voxelOctree
+\param octree
+		the voxelOctree the rays are cast through
+\param rays
+		the rays to cast
+\param hits
+		where the hit of every ray is written to, in the same order as the
+		rays
+\return
+		the number of rays that hit a voxel
+*/
+/****************************************************************************/
+unsigned VoxelRaycaster::Raycast(VoxelOctree* octree, const std::vector<VoxelRay>& rays, std::vector<VoxelRayHit>* hits)
+{
+	//the tree is built here so the workers only ever read it
+	octree->GetVector();
+	hits->resize(rays.size());
+
+	this->octree = octree;
+	this->rays = &rays;
+	this->hits = hits;
+	nextBatch = 0;
+	numOfHits = 0;
+	threadPool.Run(this);
+	return numOfHits;
+}
+/****************************************************************************/
+/*!
+\brief
+Casts batches of rays until there are none left
+\param workerIndex
+		index of the worker running this
+*/
+/****************************************************************************/
+void VoxelRaycaster::Execute(const unsigned workerIndex)
+{
+	const unsigned numOfRays = rays->size();
+	unsigned workerHits = 0;
+	for(;;)
+	{
+		const unsigned first = nextBatch.fetch_add(1) * voxelRaycasterBatchSize;
+		if(first >= numOfRays)
+		{
+			break;
+		}
+		const unsigned last = first + voxelRaycasterBatchSize < numOfRays ? first + voxelRaycasterBatchSize : numOfRays;
+		for(unsigned ray = first; ray < last; ++ray)
+		{
+			if(octree->Raycast((*rays)[ray], &(*hits)[ray]))
+			{
+				++workerHits;
+			}
+		}
+	}
+	numOfHits += workerHits;
+}
@@ -0,0 +1,48 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file VoxelRaycaster.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Casts many rays through a voxelOctree at once
+*/
+/****************************************************************************/
+#include "VoxelOctree.h"
+#include "ThreadPool.h"
+#include <atomic>
+/****************************************************************************/
+/*!
+\brief
+number of rays a worker takes at a time
+*/
+/****************************************************************************/
+const unsigned voxelRaycasterBatchSize = 256;
+/****************************************************************************/
+/*!
+Class VoxelRaycaster:
+\brief
+Casts a batch of rays through a voxelOctree, like for picking many points
+or ray tracing a frame of voxels. The workers of a thread pool take the rays
+a few at a time, and each ray writes to its own hit so they never share
+anything but the tree.
+*/
+/****************************************************************************/
+class VoxelRaycaster : public Task
+{
+public:
+	VoxelRaycaster(const unsigned numOfWorkers = 0);
+	~VoxelRaycaster();
+	unsigned Raycast(VoxelOctree* octree, const std::vector<VoxelRay>& rays, std::vector<VoxelRayHit>* hits);
+	virtual void Execute(const unsigned workerIndex);
+private:
+	VoxelRaycaster(const VoxelRaycaster&);
+	VoxelRaycaster& operator=(const VoxelRaycaster&);
+
+	ThreadPool threadPool;
+	VoxelOctree* octree;
+	const std::vector<VoxelRay>* rays;
+	std::vector<VoxelRayHit>* hits;
+	std::atomic<unsigned> nextBatch;
+	std::atomic<unsigned> numOfHits;
+};
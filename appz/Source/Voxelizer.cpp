@@ -0,0 +1,350 @@
+#include "Voxelizer.h"
+#include <xmmintrin.h>
+#include <cmath>
+#include <algorithm>
+/****************************************************************************/
+/*!
+\file Voxelizer.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Turns meshes into voxels
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Constructor
+\param numOfWorkers
+		number of threads that voxelize, 0 to use one for every core
+*/
+/****************************************************************************/
+Voxelizer::Voxelizer(const unsigned numOfWorkers)
+	:
+threadPool(numOfWorkers),
+voxelSize(1)
+{
+	workerOwners.resize(threadPool.GetNumOfWorkers());
+	nextTile = 0;
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+Voxelizer::~Voxelizer()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Adds the voxels that the triangles of a mesh pass through to a voxelOctree.
+The voxel at (x, y, z) is a cube voxelSize wide centred at (x, y, z) *
+voxelSize and takes the color of the first triangle in the mesh that
+touches it. Voxels outside of the range of the voxelOctree are left out
+when it is built.
+\param mesh
+		the mesh to be voxelized
+\param voxelSize
+		width of a voxel in the mesh's units
+\param octree
+		the voxelOctree the voxels are added to
+\return
+		the number of voxels added
+*/
+/****************************************************************************/
+unsigned Voxelizer::Voxelize(const Mesh* mesh, const float voxelSize, VoxelOctree* octree)
+{
+	this->voxelSize = voxelSize;
+	SetUpTriangles(mesh);
+	if(triangles.empty())
+	{
+		return 0;
+	}
+	BinTriangles();
+
+	nextTile = 0;
+	threadPool.Run(this);
+
+	//added in tile order so the result does not depend on which worker took which tile
+	unsigned numOfVoxels = 0;
+	for(std::vector<std::vector<Voxel> >::const_iterator tile = tileVoxels.begin(); tile != tileVoxels.end(); ++tile)
+	{
+		for(std::vector<Voxel>::const_iterator voxel = tile->begin(); voxel != tile->end(); ++voxel)
+		{
+			octree->AddVoxel(*voxel);
+		}
+		numOfVoxels += tile->size();
+	}
+	return numOfVoxels;
+}
+/****************************************************************************/
+/*!
+\brief
+Works through tiles until there are none left
+\param workerIndex
+		index of the worker running this
+*/
+/****************************************************************************/
+void Voxelizer::Execute(const unsigned workerIndex)
+{
+	const unsigned totalTiles = tileTriangles.size();
+	for(;;)
+	{
+		const unsigned tile = nextTile.fetch_add(1);
+		if(tile >= totalTiles)
+		{
+			break;
+		}
+		if(!tileTriangles[tile].empty())
+		{
+			VoxelizeTile(tile, workerOwners[workerIndex]);
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Works out the separating axes of every triangle in the mesh. These are the
+normal of the triangle and the cross products of its edges with the axes
+of the voxel. A voxel overlaps the triangle if its centre lands within the
+triangle's range on all of them.
+\param mesh
+		the mesh to be voxelized
+*/
+/****************************************************************************/
+void Voxelizer::SetUpTriangles(const Mesh* mesh)
+{
+	const float halfSize = voxelSize * 0.5f;
+	triangles.resize(mesh->GetSize());
+
+	std::vector<VoxelizerTriangle>::iterator triangle = triangles.begin();
+	for(const Polygonn* polygon = mesh->GetBegin(); polygon != mesh->GetEnd(); ++polygon, ++triangle)
+	{
+		const Vector3 vertices[3] = {polygon->vertex1.pos, polygon->vertex2.pos, polygon->vertex3.pos};
+		const Vector3 edges[3] = {vertices[1] - vertices[0], vertices[2] - vertices[1], vertices[0] - vertices[2]};
+
+		Vector3 axes[numOfVoxelizerAxes];
+		for(unsigned edge = 0; edge < 3; ++edge)
+		{
+			axes[edge * 3] = Vector3(0, -edges[edge].z, edges[edge].y);
+			axes[edge * 3 + 1] = Vector3(edges[edge].z, 0, -edges[edge].x);
+			axes[edge * 3 + 2] = Vector3(-edges[edge].y, edges[edge].x, 0);
+		}
+		axes[9] = edges[0].Cross(edges[1]);
+
+		for(unsigned axis = 0; axis < numOfVoxelizerAxes; ++axis)
+		{
+			const float projection1 = axes[axis].Dot(vertices[0]);
+			const float projection2 = axes[axis].Dot(vertices[1]);
+			const float projection3 = axes[axis].Dot(vertices[2]);
+			const float radius = halfSize * (fabs(axes[axis].x) + fabs(axes[axis].y) + fabs(axes[axis].z));
+
+			triangle->axisX[axis] = axes[axis].x;
+			triangle->axisY[axis] = axes[axis].y;
+			triangle->axisZ[axis] = axes[axis].z;
+			triangle->lowest[axis] = std::min(projection1, std::min(projection2, projection3)) - radius;
+			triangle->highest[axis] = std::max(projection1, std::max(projection2, projection3)) + radius;
+		}
+
+		for(unsigned axis = 0; axis < 3; ++axis)
+		{
+			const float coordinate1 = (&vertices[0].x)[axis];
+			const float coordinate2 = (&vertices[1].x)[axis];
+			const float coordinate3 = (&vertices[2].x)[axis];
+			triangle->minCell[axis] = static_cast<int>(floor(std::min(coordinate1, std::min(coordinate2, coordinate3)) / voxelSize + 0.5f));
+			triangle->maxCell[axis] = static_cast<int>(floor(std::max(coordinate1, std::max(coordinate2, coordinate3)) / voxelSize + 0.5f));
+		}
+
+		triangle->color.Set(
+			(polygon->vertex1.color.r + polygon->vertex2.color.r + polygon->vertex3.color.r) / 3,
+			(polygon->vertex1.color.g + polygon->vertex2.color.g + polygon->vertex3.color.g) / 3,
+			(polygon->vertex1.color.b + polygon->vertex2.color.b + polygon->vertex3.color.b) / 3);
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Splits the bounds of the mesh into tiles and lists the triangles touching
+each of them
+*/
+/****************************************************************************/
+void Voxelizer::BinTriangles()
+{
+	int maxCell[3];
+	for(unsigned axis = 0; axis < 3; ++axis)
+	{
+		minCell[axis] = triangles.front().minCell[axis];
+		maxCell[axis] = triangles.front().maxCell[axis];
+	}
+	for(std::vector<VoxelizerTriangle>::const_iterator triangle = triangles.begin(); triangle != triangles.end(); ++triangle)
+	{
+		for(unsigned axis = 0; axis < 3; ++axis)
+		{
+			minCell[axis] = std::min(minCell[axis], triangle->minCell[axis]);
+			maxCell[axis] = std::max(maxCell[axis], triangle->maxCell[axis]);
+		}
+	}
+	for(unsigned axis = 0; axis < 3; ++axis)
+	{
+		numOfTiles[axis] = (maxCell[axis] - minCell[axis]) / voxelizerTileSize + 1;
+	}
+
+	//the lists are cleared instead of thrown away so that their memory is reused by the next mesh
+	const unsigned totalTiles = numOfTiles[0] * numOfTiles[1] * numOfTiles[2];
+	for(std::vector<std::vector<unsigned> >::iterator tile = tileTriangles.begin(); tile != tileTriangles.end(); ++tile)
+	{
+		tile->clear();
+	}
+	tileTriangles.resize(totalTiles);
+	for(std::vector<std::vector<Voxel> >::iterator tile = tileVoxels.begin(); tile != tileVoxels.end(); ++tile)
+	{
+		tile->clear();
+	}
+	tileVoxels.resize(totalTiles);
+
+	for(unsigned index = 0; index < triangles.size(); ++index)
+	{
+		const VoxelizerTriangle& triangle = triangles[index];
+		int firstTile[3];
+		int lastTile[3];
+		for(unsigned axis = 0; axis < 3; ++axis)
+		{
+			firstTile[axis] = (triangle.minCell[axis] - minCell[axis]) / voxelizerTileSize;
+			lastTile[axis] = (triangle.maxCell[axis] - minCell[axis]) / voxelizerTileSize;
+		}
+		for(int z = firstTile[2]; z <= lastTile[2]; ++z)
+		{
+			for(int y = firstTile[1]; y <= lastTile[1]; ++y)
+			{
+				for(int x = firstTile[0]; x <= lastTile[0]; ++x)
+				{
+					tileTriangles[(z * numOfTiles[1] + y) * numOfTiles[0] + x].push_back(index);
+				}
+			}
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Finds the voxels in a tile that its triangles pass through. Voxels are
+tested 4 at a time along x.
+\param tile
+		index of the tile
+\param owners
+		the worker's scratch space for marking the voxels of the tile
+*/
+/****************************************************************************/
+void Voxelizer::VoxelizeTile(const unsigned tile, std::vector<unsigned>& owners)
+{
+	const int tileCell[3] =
+	{
+		minCell[0] + static_cast<int>(tile % numOfTiles[0]) * voxelizerTileSize,
+		minCell[1] + static_cast<int>(tile / numOfTiles[0] % numOfTiles[1]) * voxelizerTileSize,
+		minCell[2] + static_cast<int>(tile / (numOfTiles[0] * numOfTiles[1])) * voxelizerTileSize
+	};
+	//0 for voxels no triangle touched, otherwise the index of the first triangle that did + 1
+	owners.assign(voxelizerTileSize * voxelizerTileSize * voxelizerTileSize, 0);
+
+	const __m128 size = _mm_set1_ps(voxelSize);
+	const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+	const std::vector<unsigned>& list = tileTriangles[tile];
+	for(std::vector<unsigned>::const_iterator index = list.begin(); index != list.end(); ++index)
+	{
+		const VoxelizerTriangle& triangle = triangles[*index];
+		int first[3];
+		int last[3];
+		for(unsigned axis = 0; axis < 3; ++axis)
+		{
+			first[axis] = std::max(triangle.minCell[axis], tileCell[axis]);
+			last[axis] = std::min(triangle.maxCell[axis], tileCell[axis] + voxelizerTileSize - 1);
+		}
+
+		__m128 axisX[numOfVoxelizerAxes];
+		__m128 lowest[numOfVoxelizerAxes];
+		__m128 highest[numOfVoxelizerAxes];
+		for(unsigned axis = 0; axis < numOfVoxelizerAxes; ++axis)
+		{
+			axisX[axis] = _mm_set1_ps(triangle.axisX[axis]);
+			lowest[axis] = _mm_set1_ps(triangle.lowest[axis]);
+			highest[axis] = _mm_set1_ps(triangle.highest[axis]);
+		}
+
+		for(int z = first[2]; z <= last[2]; ++z)
+		{
+			for(int y = first[1]; y <= last[1]; ++y)
+			{
+				//the y and z parts of the projections are the same for the whole row
+				__m128 rowProjection[numOfVoxelizerAxes];
+				for(unsigned axis = 0; axis < numOfVoxelizerAxes; ++axis)
+				{
+					rowProjection[axis] = _mm_set1_ps((triangle.axisY[axis] * y + triangle.axisZ[axis] * z) * voxelSize);
+				}
+				unsigned* row = &owners[((z - tileCell[2]) * voxelizerTileSize + y - tileCell[1]) * voxelizerTileSize];
+
+				//the plane of the triangle cuts the row down to the few voxels near it
+				int rowFirst = first[0];
+				int rowLast = last[0];
+				const float normalX = triangle.axisX[numOfVoxelizerAxes - 1];
+				if(normalX != 0)
+				{
+					const float planeProjection = (triangle.axisY[numOfVoxelizerAxes - 1] * y + triangle.axisZ[numOfVoxelizerAxes - 1] * z) * voxelSize;
+					float bound1 = (triangle.lowest[numOfVoxelizerAxes - 1] - planeProjection) / (normalX * voxelSize);
+					float bound2 = (triangle.highest[numOfVoxelizerAxes - 1] - planeProjection) / (normalX * voxelSize);
+					if(bound1 > bound2)
+					{
+						std::swap(bound1, bound2);
+					}
+					//clamp before converting since a nearly flat normal puts the bounds far outside of what an int holds
+					bound1 = std::min(std::max(bound1, static_cast<float>(rowFirst)), static_cast<float>(rowLast));
+					bound2 = std::min(std::max(bound2, static_cast<float>(rowFirst)), static_cast<float>(rowLast));
+					rowFirst = static_cast<int>(floor(bound1));
+					rowLast = static_cast<int>(ceil(bound2));
+				}
+
+				for(int x = rowFirst; x <= rowLast; x += 4)
+				{
+					const __m128 centreX = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes), size);
+					__m128 overlapping = _mm_cmpeq_ps(centreX, centreX);
+					for(unsigned axis = 0; axis < numOfVoxelizerAxes; ++axis)
+					{
+						const __m128 projection = _mm_add_ps(_mm_mul_ps(axisX[axis], centreX), rowProjection[axis]);
+						overlapping = _mm_and_ps(overlapping, _mm_and_ps(_mm_cmpge_ps(projection, lowest[axis]), _mm_cmple_ps(projection, highest[axis])));
+					}
+
+					int mask = _mm_movemask_ps(overlapping);
+					if(rowLast - x < 3)
+					{
+						mask &= (1 << (rowLast - x + 1)) - 1;
+					}
+					for(int lane = 0; mask; ++lane, mask >>= 1)
+					{
+						if((mask & 1) && !row[x - tileCell[0] + lane])
+						{
+							row[x - tileCell[0] + lane] = *index + 1;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<Voxel>& voxels = tileVoxels[tile];
+	Voxel voxel;
+	voxel.SetSolidityTo(1);
+	for(unsigned cell = 0; cell < owners.size(); ++cell)
+	{
+		if(owners[cell])
+		{
+			voxel.SetPositionTo(Vector3(
+				static_cast<float>(tileCell[0] + static_cast<int>(cell % voxelizerTileSize)),
+				static_cast<float>(tileCell[1] + static_cast<int>(cell / voxelizerTileSize % voxelizerTileSize)),
+				static_cast<float>(tileCell[2] + static_cast<int>(cell / (voxelizerTileSize * voxelizerTileSize)))));
+			voxel.SetColorTo(triangles[owners[cell] - 1].color);
+			voxels.push_back(voxel);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+/****************************************************************************/
+/*!
+\file Voxelizer.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+Turns meshes into voxels
+*/
+/****************************************************************************/
+#include "Mesh.h"
+#include "VoxelOctree.h"
+#include "ThreadPool.h"
+#include <atomic>
+/****************************************************************************/
+/*!
+\brief
+number of voxels along each side of the tiles the work is split into
+*/
+/****************************************************************************/
+const int voxelizerTileSize = 32;
+/****************************************************************************/
+/*!
+\brief
+number of axes a triangle and a box are tested on. The 3 axes of the box
+are left out since only boxes inside the triangle's bounds are tested
+*/
+/****************************************************************************/
+const unsigned numOfVoxelizerAxes = 10;
+/****************************************************************************/
+/*!
+Class VoxelizerTriangle:
+\brief
+A triangle set up for overlap tests against voxels. For every separating
+axis it holds the range that the centre of an overlapping voxel projects
+into, so a voxel only needs a dot product and 2 compares per axis.
+*/
+/****************************************************************************/
+class VoxelizerTriangle
+{
+public:
+	float axisX[numOfVoxelizerAxes];
+	float axisY[numOfVoxelizerAxes];
+	float axisZ[numOfVoxelizerAxes];
+	float lowest[numOfVoxelizerAxes];
+	float highest[numOfVoxelizerAxes];
+	//voxels the bounds of the triangle touch
+	int minCell[3];
+	int maxCell[3];
+	Color color;
+};
+/****************************************************************************/
+/*!
+Class Voxelizer:
+\brief
+Fills a VoxelOctree with the voxels a mesh passes through. The bounds of
+the mesh are split into tiles and the workers of a thread pool take tiles
+one at a time, so no 2 workers ever write the same voxel.
+*/
+/****************************************************************************/
+class Voxelizer : public Task
+{
+public:
+	Voxelizer(const unsigned numOfWorkers = 0);
+	~Voxelizer();
+	unsigned Voxelize(const Mesh* mesh, const float voxelSize, VoxelOctree* octree);
+	virtual void Execute(const unsigned workerIndex);
+private:
+	Voxelizer(const Voxelizer&);
+	Voxelizer& operator=(const Voxelizer&);
+
+	void SetUpTriangles(const Mesh* mesh);
+	void BinTriangles();
+	void VoxelizeTile(const unsigned tile, std::vector<unsigned>& owners);
+
+	ThreadPool threadPool;
+	std::vector<VoxelizerTriangle> triangles;
+	//triangles touching each tile and the voxels found in each tile
+	std::vector<std::vector<unsigned> > tileTriangles;
+	std::vector<std::vector<Voxel> > tileVoxels;
+	//each worker marks which triangle reached each voxel of its tile first
+	std::vector<std::vector<unsigned> > workerOwners;
+	std::atomic<unsigned> nextTile;
+	int minCell[3];
+	int numOfTiles[3];
+	float voxelSize;
+};
@@ -48,39 +48,9 @@ Updates the keyboard values
 /****************************************************************************/
 void WindowsKeyboard::UpdateInput()
 {
-	//clear the buffer
-	keyboardbuffer.swap(std::queue<char>());
 	for(int index = 0; index < 256; index++)
 	{
-		unsigned short keyIsPressed = GetKey(index);
-		if(keyAlreadyPressed[index] && !keyIsPressed)
-		{
-			keyAlreadyPressed[index] = false;
-			keyispressed[index] = false;
-			keyishold[index] = false;
-		}
-		else if(!keyAlreadyPressed[index] && keyIsPressed)
-		{
-			keyAlreadyPressed[index] = true;
-			keyispressed[index] = true;
-			keyishold[index] = true;
-		}
-		else if(keyAlreadyPressed[index] && keyIsPressed)
-		{
-			keyispressed[index] = false;
-			keyishold[index] = true;
-		}
-		else
-		{
-			keyispressed[index] = false;
-			keyishold[index] = false;
-		}
-	}
-	for(unsigned index = ' '; index < '~'; index++)
-	{
-		if(IsKeyPressed(index))
-		{
-			keyboardbuffer.push((char)index);
-		}
+		SetKeyState(index, GetKey(index));
 	}
+	FillKeyboardBuffer();
 }
\ No newline at end of file
@@ -1,10 +1,25 @@
 
 
 #include "Application.h"
+#include <cstring>
 
-int main( void )
+//usage: appz [--record file | --replay file]
+int main(int argc, char* argv[])
 {
-	Application app;
+	Application::APPLICATION_MODE mode = Application::MODE_PLAY;
+	std::string recordingPath;
+	if(argc >= 3 && strcmp(argv[1], "--record") == 0)
+	{
+		mode = Application::MODE_RECORD;
+		recordingPath = argv[2];
+	}
+	else if(argc >= 3 && strcmp(argv[1], "--replay") == 0)
+	{
+		mode = Application::MODE_REPLAY;
+		recordingPath = argv[2];
+	}
+
+	Application app(mode, recordingPath);
 	app.Init();
 	app.Run();
 	app.Exit();
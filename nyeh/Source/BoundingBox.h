@@ -15,6 +15,7 @@ public:
 	Vector3 GetDistanceFrom(const BoundingBox<t>& box) const;
 	Vector3 GetDisplacement() const;
 
+	bool IsEmpty() const;
 	bool IsInside(const Vector3& point) const;
 	bool IsOverlapping(const BoundingBox<t>& box) const;
 	bool IsBehind(const BoundingBox<t>& box) const;
@@ -74,6 +75,14 @@ void BoundingBox<t>::ResizeToFit(const BoundingBox<t>& box)
 	}
 }
 
+template <class t>
+bool BoundingBox<t>::IsEmpty() const
+{
+	return rangeX.start > rangeX.end ||
+		rangeY.start > rangeY.end ||
+		rangeZ.start > rangeZ.end;
+}
+
 template <class t>
 bool BoundingBox<t>::IsInside(const Vector3& point) const
 {
@@ -1,5 +1,9 @@
 #include "DrawOrder.h"
 #include "Mesh.h"
+#include <cfloat>
+
+//the last revision given to the model transform of a DrawOrder. 0 is never given so no DrawOrder starts up to date
+static unsigned lastTransformRevision = 0;
 /****************************************************************************/
 /*!
 \file DrawOrder.cpp
@@ -28,10 +32,18 @@ Constructor for DrawOrder
 /****************************************************************************/
 DrawOrder::DrawOrder(Mesh* geometry, Material* material, DrawOrder* parent, bool enableLight)
 	:
+parent(NULL),
+enableLight(enableLight),
 geometry(geometry),
 material(material),
-enableLight(enableLight),
-parent(NULL)
+bounds(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX)),
+boundsLocalRevision(0),
+boundsGeometry(NULL),
+boundsMeshRevision(0),
+childrenChanged(false),
+parentRevision(0),
+revision(0),
+localRevision(0)
 {
 	SetParentAs(parent);
 }
@@ -63,6 +75,7 @@ DrawOrder::~DrawOrder()
 				break;
 			}
 		}
+		parent->childrenChanged = true;
 	}
 }
 /****************************************************************************/
@@ -85,21 +98,24 @@ Sets the DrawOrder's parent and the new parent's children
 /****************************************************************************/
 void DrawOrder::SetParentAs(DrawOrder* parent)
 {
-	if(parent)
+	//leave the old parent, otherwise the DrawOrder is walked through twice when it gets a new one
+	if(this->parent)
 	{
-		for(std::vector<DrawOrder*>::iterator child = parent->children.begin(); child != parent->children.end(); ++child)
+		for(std::vector<DrawOrder*>::iterator child = this->parent->children.begin(); child != this->parent->children.end(); ++child)
 		{
 			if(*child == this)
 			{
-				parent->children.erase(child);
+				this->parent->children.erase(child);
 				break;
 			}
 		}
+		this->parent->childrenChanged = true;
 	}
 	this->parent = parent;
 	if(parent)
 	{
 		parent->children.push_back(this);
+		parent->childrenChanged = true;
 	}
 }
 /****************************************************************************/
@@ -108,13 +124,10 @@ void DrawOrder::SetParentAs(DrawOrder* parent)
 Returns the DrawOrder's(incomplete) modelTransform
 */
 /****************************************************************************/
-Mtx44 DrawOrder::GetModelTransform() const
+const Mtx44& DrawOrder::GetModelTransform() const
 {
-	if(parent)
-	{
-		return parent->GetModelTransform() * transform.TranslationMatrix() * transform.RotationMatrix() * transform.ScalationMatrix();
-	}
-	return transform.TranslationMatrix() * transform.RotationMatrix() * transform.ScalationMatrix();
+	UpdateMatrices();
+	return modelTransform;
 }
 /****************************************************************************/
 /*!
@@ -122,18 +135,61 @@ Mtx44 DrawOrder::GetModelTransform() const
 Returns the DrawOrder's complete modelTransform
 */
 /****************************************************************************/
-Mtx44 DrawOrder::GetMatrix() const
+const Mtx44& DrawOrder::GetMatrix() const
 {
-	Mtx44 modelTransform;
+	UpdateMatrices();
+	return matrix;
+}
+/****************************************************************************/
+/*!
+\brief
+Rebuilds the cached matrices that are dirty. The local matrices are dirty
+when transform or selfTransform changed since they were built, and the
+world matrices are dirty when the local ones are or when the model
+transform of the parent changed. Only the parents up to the root are
+checked, so a DrawOrder is only rebuilt the first time it is used after
+something above it moved.
+*/
+/****************************************************************************/
+void DrawOrder::UpdateMatrices() const
+{
+	bool dirty = revision == 0;
+	bool selfDirty = dirty;
+	if(dirty || transform != cachedTransform)
+	{
+		cachedTransform = transform;
+		localTransform = transform.TranslationMatrix() * transform.RotationMatrix() * transform.ScalationMatrix();
+		dirty = selfDirty = true;
+	}
+	if(selfDirty || selfTransform != cachedSelfTransform)
+	{
+		cachedSelfTransform = selfTransform;
+		localMatrix = transform.TranslationMatrix() * selfTransform.TranslationMatrix() * transform.RotationMatrix() * selfTransform.RotationMatrix() * transform.ScalationMatrix() * selfTransform.ScalationMatrix();
+		selfDirty = true;
+		localRevision = ++lastTransformRevision;
+	}
+
+	unsigned newParentRevision = 0;
 	if(parent)
 	{
-		modelTransform = parent->GetModelTransform();
+		parent->UpdateMatrices();
+		newParentRevision = parent->revision;
 	}
-	else
+	if(newParentRevision != parentRevision)
+	{
+		parentRevision = newParentRevision;
+		dirty = selfDirty = true;
+	}
+
+	if(dirty)
+	{
+		modelTransform = parent ? parent->modelTransform * localTransform : localTransform;
+		revision = ++lastTransformRevision;
+	}
+	if(selfDirty)
 	{
-		modelTransform.SetToIdentity();
+		matrix = parent ? parent->modelTransform * localMatrix : localMatrix;
 	}
-	return modelTransform * transform.TranslationMatrix() * selfTransform.TranslationMatrix() * transform.RotationMatrix() * selfTransform.RotationMatrix() * transform.ScalationMatrix() * selfTransform.ScalationMatrix();
 }
 /****************************************************************************/
 /*!
@@ -190,4 +246,63 @@ Mtx44 DrawOrder::GetScaleMatrix() const
 const std::vector<DrawOrder*>& DrawOrder::GetChildrenVector() const
 {
 	return children;
+}
+/****************************************************************************/
+/*!
+\brief
+Works out the bounds of the DrawOrder and all of its children. Has to be
+called on the top of the hierarchy after anything in it was moved or its
+meshes were changed, and before it is culled. Only the DrawOrders whose
+local matrices, mesh or children changed since the last call, and the ones
+above them, work out their bounds again. Moving a DrawOrder doesn't change
+the bounds of its children since they are in its space
+\return
+		whether the bounds of the DrawOrder changed
+*/
+/****************************************************************************/
+bool DrawOrder::UpdateBounds()
+{
+	UpdateMatrices();
+	bool changed = childrenChanged || localRevision != boundsLocalRevision;
+	for(std::vector<DrawOrder*>::const_iterator child = children.begin(); child != children.end(); ++child)
+	{
+		if((*child)->UpdateBounds())
+		{
+			changed = true;
+		}
+	}
+	const unsigned meshRevision = geometry ? geometry->GetRevision() : 0;
+	if(!changed && geometry == boundsGeometry && meshRevision == boundsMeshRevision)
+	{
+		return false;
+	}
+	boundsLocalRevision = localRevision;
+	boundsGeometry = geometry;
+	boundsMeshRevision = meshRevision;
+	childrenChanged = false;
+
+	//children are placed by the transform alone while the geometry also has the self transform
+	MeshBox childBounds(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
+	for(std::vector<DrawOrder*>::const_iterator child = children.begin(); child != children.end(); ++child)
+	{
+		childBounds.ResizeToFit((*child)->bounds);
+	}
+	bounds = TransformMeshBox(childBounds, localTransform);
+
+	if(geometry)
+	{
+		bounds.ResizeToFit(TransformMeshBox(geometry->GetBoundingBox(), localMatrix));
+	}
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the bounds of the DrawOrder and all of its children in the space of
+its parent, as of the last UpdateBounds
+*/
+/****************************************************************************/
+const MeshBox& DrawOrder::GetBounds() const
+{
+	return bounds;
 }
\ No newline at end of file
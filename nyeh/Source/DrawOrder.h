@@ -26,15 +26,17 @@ public:
 	DrawOrder(Mesh* geometry = NULL, Material* material = NULL, DrawOrder* parent = NULL, bool enableLight = false);
 	~DrawOrder();
 	void SetTo(Mesh* geometry = NULL, Material* material = NULL, DrawOrder* parent = NULL, bool enableLight = false);
-	Mtx44 GetMatrix() const;
+	const Mtx44& GetMatrix() const;
 	Mtx44 GetTranslationMatrix() const;
 	Mtx44 GetRotationMatrix() const;
 	Mtx44 GetScaleMatrix() const;
 	Vector3 GetGlobalPosition() const;
 	DrawOrder* GetParent() const;
 	void SetParentAs(DrawOrder* parent);
-	Mtx44 GetModelTransform() const;
+	const Mtx44& GetModelTransform() const;
 	const std::vector<DrawOrder*>& GetChildrenVector() const;
+	bool UpdateBounds();
+	const MeshBox& GetBounds() const;
 
 	DrawOrder* parent;
 	bool enableLight;
@@ -45,5 +47,31 @@ public:
 	Transformation selfTransform;
 
 private:
+	void UpdateMatrices() const;
+
 	std::vector<DrawOrder*> children;
+	//the bounds of the geometry of the DrawOrder and all of its children in the space of its parent
+	MeshBox bounds;
+	//what the bounds were worked out from, so they are only worked out again when one of them changes
+	unsigned boundsLocalRevision;
+	const Mesh* boundsGeometry;
+	unsigned boundsMeshRevision;
+	//set when a child is added or removed since the bounds were worked out
+	bool childrenChanged;
+
+	//the transforms the cached matrices were built from, so that changing them marks the matrices dirty
+	mutable Transformation cachedTransform;
+	mutable Transformation cachedSelfTransform;
+	//the revision of the parent's model transform the world matrices were built from, 0 if there was no parent
+	mutable unsigned parentRevision;
+	//changes every time the model transform changes so children know to rebuild theirs
+	mutable unsigned revision;
+	//changes every time the local matrices change, which the parent doesn't affect
+	mutable unsigned localRevision;
+	//transform and transform with selfTransform, relative to the parent
+	mutable Mtx44 localTransform;
+	mutable Mtx44 localMatrix;
+	//the same in world space
+	mutable Mtx44 modelTransform;
+	mutable Mtx44 matrix;
 };
\ No newline at end of file
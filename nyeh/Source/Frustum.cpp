@@ -0,0 +1,132 @@
+#include "Frustum.h"
+/****************************************************************************/
+/*!
+\file Frustum.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class used to check what is inside of the camera's view
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+\brief
+Default constructor. Everything is inside of the frustum until it is set
+*/
+/****************************************************************************/
+Frustum::Frustum()
+{
+	for(unsigned plane = 0; plane < P_TOTAL; ++plane)
+	{
+		distances[plane] = 0;
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Constructs the frustum of a view projection matrix
+\param viewProjection
+		the projection matrix multiplied by the view matrix
+*/
+/****************************************************************************/
+Frustum::Frustum(const Mtx44& viewProjection)
+{
+	SetTo(viewProjection);
+}
+/****************************************************************************/
+/*!
+\brief
+Default destructor
+*/
+/****************************************************************************/
+Frustum::~Frustum()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Takes the planes out of a view projection matrix
+\param viewProjection
+		the projection matrix multiplied by the view matrix
+*/
+/****************************************************************************/
+void Frustum::SetTo(const Mtx44& viewProjection)
+{
+	//the matrix is column major so row i is a[i], a[4 + i], a[8 + i], a[12 + i]
+	const float* a = viewProjection.a;
+	for(unsigned plane = 0; plane < P_TOTAL; ++plane)
+	{
+		//left and right come from row 0, bottom and top from row 1 and near and far from row 2
+		const unsigned row = plane / 2;
+		const float sign = plane % 2 ? -1.0f : 1.0f;
+
+		normals[plane].Set(a[3] + sign * a[row], a[7] + sign * a[4 + row], a[11] + sign * a[8 + row]);
+		distances[plane] = a[15] + sign * a[12 + row];
+
+		const float length = normals[plane].Length();
+		if(length > 0)
+		{
+			normals[plane] /= length;
+			distances[plane] /= length;
+		}
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether a point is inside of the frustum
+\param point
+		the point to check
+*/
+/****************************************************************************/
+bool Frustum::IsInside(const Vector3& point) const
+{
+	return IsOverlapping(point, 0);
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether a sphere is at least partly inside of the frustum
+\param centre
+		the centre of the sphere
+\param radius
+		the radius of the sphere
+*/
+/****************************************************************************/
+bool Frustum::IsOverlapping(const Vector3& centre, const float radius) const
+{
+	for(unsigned plane = 0; plane < P_TOTAL; ++plane)
+	{
+		if(normals[plane].Dot(centre) + distances[plane] < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns whether a box is at least partly inside of the frustum. Boxes near
+the corners of the frustum may be let through even when they are outside.
+\param min
+		the corner of the box with the smallest values
+\param max
+		the corner of the box with the biggest values
+*/
+/****************************************************************************/
+bool Frustum::IsOverlapping(const Vector3& min, const Vector3& max) const
+{
+	for(unsigned plane = 0; plane < P_TOTAL; ++plane)
+	{
+		//only the corner furthest along the normal has to be checked
+		const Vector3& normal = normals[plane];
+		const Vector3 corner(normal.x >= 0 ? max.x : min.x, normal.y >= 0 ? max.y : min.y, normal.z >= 0 ? max.z : min.z);
+		if(normal.Dot(corner) + distances[plane] < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
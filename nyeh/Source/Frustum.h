@@ -0,0 +1,49 @@
+#pragma once
+#include "Mtx44.h"
+#include "Vector3.h"
+/****************************************************************************/
+/*!
+\file Frustum.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A class used to check what is inside of the camera's view
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class Frustum:
+\brief
+The 6 planes around the volume a camera can see, taken from a view
+projection matrix. The normals of the planes point into the volume.
+*/
+/****************************************************************************/
+class Frustum
+{
+public:
+	Frustum();
+	Frustum(const Mtx44& viewProjection);
+	~Frustum();
+
+	void SetTo(const Mtx44& viewProjection);
+
+	bool IsInside(const Vector3& point) const;
+	bool IsOverlapping(const Vector3& centre, const float radius) const;
+	bool IsOverlapping(const Vector3& min, const Vector3& max) const;
+private:
+	enum PLANE_TYPE
+	{
+		P_LEFT = 0,
+		P_RIGHT,
+		P_BOTTOM,
+		P_TOP,
+		P_NEAR,
+		P_FAR,
+
+		P_TOTAL,
+	};
+
+	Vector3 normals[P_TOTAL];
+	float distances[P_TOTAL];
+};
@@ -1,5 +1,10 @@
 #include "Mesh.h"
 #include <limits>
+#include <cfloat>
+#include <cmath>
+
+//the last revision given to the bounds of a Mesh. Handed out from 1 counter so a mesh made where another one was freed never has its revision
+static unsigned lastBoundingBoxRevision = 0;
 /****************************************************************************/
 /*!
 \file Mesh.cpp
@@ -21,6 +26,9 @@ default constructor
 */
 /****************************************************************************/
 Mesh::Mesh(const unsigned& nPolies)
+	:
+boundingBox(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX)),
+revision(0)
 {
 	SetSize(nPolies);
 }
@@ -36,25 +44,78 @@ Mesh::~Mesh()
 /****************************************************************************/
 /*!
 \brief
-Returns the bounds of the mesh
-\param rangeX
-		the reference to the buffer storing the x-range
-\param rangeY
-		the reference to the buffer storing the y-range
-\param rangeZ
-		the reference to the buffer storing the z-range
+Returns the bounds of the mesh in its own space. The bounds are only worked
+out in UpdateBoundingBox, so they are empty until it is first called
 */
 /****************************************************************************/
 MeshBox Mesh::GetBoundingBox() const
+{
+	return boundingBox;
+}
+/****************************************************************************/
+/*!
+\brief
+Works out the bounds of the mesh from its polygons. Has to be called again
+whenever the polygons are changed
+*/
+/****************************************************************************/
+void Mesh::UpdateBoundingBox()
 {
 	//set the bounding box to the most extreme values so that the polygon's most extreme values will be stored.
-	BoundingBox<float> box(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
+	boundingBox = MeshBox(Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX), Range<float>(FLT_MAX, -FLT_MAX));
 
-	//loop through all our vertices
+	//loop through all our polygons
 	for(Polygonn* polygon = GetBegin(), *end = GetEnd(); polygon != end; ++polygon)
 	{
-		box.ResizeToFit(box);
+		boundingBox.ResizeToFit(polygon->GetBoundingBox());
+	}
+	revision = ++lastBoundingBoxRevision;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns a number that changes every time UpdateBoundingBox is called, or 0
+if it never was
+*/
+/****************************************************************************/
+unsigned Mesh::GetRevision() const
+{
+	return revision;
+}
+/****************************************************************************/
+/*!
+\brief
+Returns the box that fits around a box after it is transformed. An empty
+box stays empty
+\param box
+		the box to transform
+\param transform
+		the matrix to transform the box by
+*/
+/****************************************************************************/
+MeshBox TransformMeshBox(const MeshBox& box, const Mtx44& transform)
+{
+	if(box.IsEmpty())
+	{
+		return box;
+	}
+
+	//move the centre and take the extent of the box along each axis of the matrix
+	const float centre[3] = {box.rangeX.MidPoint(), box.rangeY.MidPoint(), box.rangeZ.MidPoint()};
+	const float extent[3] = {box.rangeX.Length() * 0.5f, box.rangeY.Length() * 0.5f, box.rangeZ.Length() * 0.5f};
+	float newCentre[3], newExtent[3];
+	for(unsigned row = 0; row < 3; ++row)
+	{
+		newCentre[row] = transform.a[12 + row];
+		newExtent[row] = 0;
+		for(unsigned column = 0; column < 3; ++column)
+		{
+			newCentre[row] += transform.a[column * 4 + row] * centre[column];
+			newExtent[row] += fabs(transform.a[column * 4 + row]) * extent[column];
+		}
 	}
 
-	return box;
+	return MeshBox(Range<float>(newCentre[0] - newExtent[0], newCentre[0] + newExtent[0]),
+		Range<float>(newCentre[1] - newExtent[1], newCentre[1] + newExtent[1]),
+		Range<float>(newCentre[2] - newExtent[2], newCentre[2] + newExtent[2]));
 }
\ No newline at end of file
@@ -35,4 +35,13 @@ public:
 	virtual void Render(const Graphics* graphics, const Mtx44& projection, const Mtx44& view, const Mtx44& transform, const Material* material, const bool& lightingEnabled, const unsigned& offset, const unsigned& count) const = 0;
 
 	virtual MeshBox GetBoundingBox() const;
-};
\ No newline at end of file
+	void UpdateBoundingBox();
+	unsigned GetRevision() const;
+private:
+	//the bounds of the polygons the last time UpdateBoundingBox was called
+	MeshBox boundingBox;
+	//changes every time the bounds are worked out so whatever was built from them knows to rebuild, 0 if they never were
+	unsigned revision;
+};
+
+MeshBox TransformMeshBox(const MeshBox& box, const Mtx44& transform);
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+/****************************************************************************/
+/*!
+\file ThreadPool.cpp
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A pool of worker threads that run a task together
+*/
+/****************************************************************************/
+Task::~Task()
+{
+}
+/****************************************************************************/
+/*!
+\brief
+Starts the worker threads
+\param numOfWorkers
+number of workers including the thread that calls Run. 0 uses one worker per hardware thread
+*/
+/****************************************************************************/
+ThreadPool::ThreadPool(const unsigned numOfWorkers)
+	:
+currentTask(NULL),
+generation(0),
+numOfBusyWorkers(0),
+stopping(false)
+{
+	unsigned total = numOfWorkers;
+	if(total == 0)
+	{
+		total = std::thread::hardware_concurrency();
+	}
+	if(total == 0)
+	{
+		total = 1;
+	}
+
+	threads.reserve(total - 1);
+	for(unsigned workerIndex = 1; workerIndex < total; ++workerIndex)
+	{
+		threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, workerIndex));
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Stops and joins the worker threads
+*/
+/****************************************************************************/
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	taskReady.notify_all();
+	for(std::vector<std::thread>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+	{
+		thread->join();
+	}
+}
+/****************************************************************************/
+/*!
+\brief
+Runs the task on every worker and waits for all of them to finish
+\param task
+the task to be run
+*/
+/****************************************************************************/
+void ThreadPool::Run(Task* task)
+{
+	if(threads.empty())
+	{
+		task->Execute(0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentTask = task;
+		numOfBusyWorkers = threads.size();
+		++generation;
+	}
+	taskReady.notify_all();
+
+	//the calling thread does its share instead of idling
+	task->Execute(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while(numOfBusyWorkers != 0)
+	{
+		taskDone.wait(lock);
+	}
+	currentTask = NULL;
+}
+/****************************************************************************/
+/*!
+\brief
+Number of workers including the thread that calls Run
+*/
+/****************************************************************************/
+unsigned ThreadPool::GetNumOfWorkers() const
+{
+	return threads.size() + 1;
+}
+/****************************************************************************/
+/*!
+\brief
+Waits for tasks and runs them until the pool is destroyed
+\param workerIndex
+index of the worker
+*/
+/****************************************************************************/
+void ThreadPool::WorkerLoop(const unsigned workerIndex)
+{
+	unsigned lastGeneration = 0;
+	for(;;)
+	{
+		Task* task = NULL;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while(!stopping && generation == lastGeneration)
+			{
+				taskReady.wait(lock);
+			}
+			if(stopping)
+			{
+				return;
+			}
+			lastGeneration = generation;
+			task = currentTask;
+		}
+
+		task->Execute(workerIndex);
+
+		bool lastOneDone = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			lastOneDone = --numOfBusyWorkers == 0;
+		}
+		if(lastOneDone)
+		{
+			taskDone.notify_one();
+		}
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+/****************************************************************************/
+/*!
+\file ThreadPool.h
+\author Muhammad Shafik Bin Mazlinan
+\par email: cyboryxmen@yahoo.com
+\brief
+A pool of worker threads that run a task together
+*/
+/****************************************************************************/
+
+/****************************************************************************/
+/*!
+Class Task:
+\brief
+Interface for work that is run by every worker of a ThreadPool. The task
+splits the work between the workers itself.
+*/
+/****************************************************************************/
+class Task
+{
+public:
+	virtual ~Task();
+	/****************************************************************************/
+	/*!
+	\brief
+	runs the task's share of work for a worker
+	\param workerIndex
+	index of the worker running the task. The thread that called ThreadPool::Run is worker 0
+	*/
+	/****************************************************************************/
+	virtual void Execute(const unsigned workerIndex) = 0;
+};
+/****************************************************************************/
+/*!
+Class ThreadPool:
+\brief
+Keeps a set of worker threads alive so that a task can be run by all of
+them without creating threads every frame. Run blocks until every worker
+is done with the task.
+*/
+/****************************************************************************/
+class ThreadPool
+{
+public:
+	ThreadPool(const unsigned numOfWorkers = 0);
+	~ThreadPool();
+	void Run(Task* task);
+	unsigned GetNumOfWorkers() const;
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+	void WorkerLoop(const unsigned workerIndex);
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable taskReady;
+	std::condition_variable taskDone;
+	Task* currentTask;
+	//bumped every time a task is posted so that the workers know there is new work
+	unsigned generation;
+	unsigned numOfBusyWorkers;
+	bool stopping;
+};
@@ -43,4 +43,18 @@ Mtx44 Transformation::Matrix() const
 	rotation = reorientate.GetInverse() * rotate.MatrixX() * rotate.MatrixY() * rotate.MatrixZ() * reorientate;
 
 	return TranslationMatrix() * RotationMatrix() * ScalationMatrix();
+}
+
+//exact so that a cached matrix is rebuilt however little the values changed
+bool Transformation::operator==(const Transformation& rhs) const
+{
+	return translate.x == rhs.translate.x && translate.y == rhs.translate.y && translate.z == rhs.translate.z &&
+		rotate.yaw == rhs.rotate.yaw && rotate.pitch == rhs.rotate.pitch && rotate.roll == rhs.rotate.roll &&
+		scale.x == rhs.scale.x && scale.y == rhs.scale.y && scale.z == rhs.scale.z &&
+		pivot.x == rhs.pivot.x && pivot.y == rhs.pivot.y && pivot.z == rhs.pivot.z;
+}
+
+bool Transformation::operator!=(const Transformation& rhs) const
+{
+	return !(*this == rhs);
 }
\ No newline at end of file
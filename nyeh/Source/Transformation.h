@@ -18,6 +18,9 @@ public:
 	Mtx44 ScalationMatrix() const;
 	Mtx44 Matrix() const;
 
+	bool operator==(const Transformation& rhs) const;
+	bool operator!=(const Transformation& rhs) const;
+
 	Vector3 translate;
 	Rotation rotate;
 	Vector3 scale;